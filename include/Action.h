@@ -1,39 +1,69 @@
 #pragma once
-#include <string>
+#include <SFML/Window/Keyboard.hpp>
+#include <array>
+#include <cstdint>
 #include <functional>
-#include <map>
+#include <string>
 
 enum class ActionType { Start, End };
 
-using ActionMap = std::map<int, std::string>;
+// Small dense id for an action name. Names are interned once, when keys are
+// bound; input handling and dispatch only see the id. 0 means "no action".
+using ActionId = std::uint16_t;
+
+// scancode -> action lookup, one flat array per scene
+class ActionMap {
+    std::array<ActionId, sf::Keyboard::ScancodeCount> m_actions{};
+
+public:
+    void set(int key, ActionId id) {
+        if (key >= 0 && static_cast<std::size_t>(key) < m_actions.size()) m_actions[key] = id;
+    }
+
+    ActionId find(int key) const {
+        return key >= 0 && static_cast<std::size_t>(key) < m_actions.size() ? m_actions[key] : ActionId{0};
+    }
+};
 
 class Action {
-    std::string m_name;
-    ActionType  m_type;
+    ActionId   m_id;
+    ActionType m_type;
 
 public:
-    Action(std::string name, ActionType type) : m_name(std::move(name)), m_type(type) {}
+    Action(ActionId id, ActionType type) : m_id(id), m_type(type) {}
+
+    // by name, for config and tools; interns the name if it is new
+    Action(const std::string& name, ActionType type) : m_id(intern(name)), m_type(type) {}
 
-    const std::string& name() const noexcept { return m_name; }
-    ActionType         type() const noexcept { return m_type; }
+    ActionId   id()   const noexcept { return m_id; }
+    ActionType type() const noexcept { return m_type; }
+
+    // for config and debugging only
+    const std::string& name() const noexcept { return nameOf(m_id); }
 
     bool isStart() const noexcept { return m_type == ActionType::Start; }
     bool isEnd()   const noexcept { return m_type == ActionType::End; }
 
     // comparisons for containers/tests
     bool operator==(const Action& rhs) const noexcept {
-        return m_type == rhs.m_type && m_name == rhs.m_name;
+        return m_type == rhs.m_type && m_id == rhs.m_id;
     }
     bool operator!=(const Action& rhs) const noexcept { return !(*this == rhs); }
+
+    // the id for a name, added on first use; not thread safe (bind keys on the main thread)
+    static ActionId           intern(const std::string& name);
+    static ActionId           find(const std::string& name);       // 0 if never interned
+    static const std::string& nameOf(ActionId id);                  // "" for 0 or unknown ids
 };
 
+using ActionHandler = std::function<void(const Action&)>;
+
 // allow use as key in unordered containers
 namespace std {
 template<>
 struct hash<Action> {
     size_t operator()(const Action& a) const noexcept {
-        // simple combine: hash(name) ^ (type<<1)
-        return std::hash<std::string>{}(a.name()) ^ (static_cast<size_t>(a.type()) << 1);
+        return (static_cast<size_t>(a.id()) << 1) ^ static_cast<size_t>(a.type());
     }
 };
 }
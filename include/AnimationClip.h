@@ -0,0 +1,42 @@
+#pragma once
+
+#include "AssetTable.h"
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+
+// Immutable animation data shared by every entity that plays it: frame rects
+// on one texture and how long each frame is shown. Per-entity state is only
+// the playhead in CAnimation.
+struct AnimationClip
+{
+    std::string              name;
+    std::string              source;              // texture the frames were cut from
+    const sf::Texture *      texture = nullptr;
+    TextureId                textureId;           // streamed source texture; empty once on an atlas page
+    std::vector<sf::IntRect> frames;
+    std::vector<float>       durations;           // seconds per frame, 0 holds the frame
+    sf::Vector2f             size;                // first frame
+    sf::Vector2f             origin;              // centre of the first frame
+    float                    length  = 0.f;       // 0 for clips that never advance
+
+    // the fallback clip: one empty frame and no texture, so it draws nothing
+    AnimationClip() : frames(1), durations(1, 0.f) {}
+    AnimationClip(const std::string & name, const std::string & source, const sf::Texture & texture,
+                  std::vector<sf::IntRect> frames, float frameSeconds)
+        : name(name), source(source), texture(&texture), frames(std::move(frames))
+    {
+        if (this->frames.empty()) this->frames.emplace_back();
+        size   = sf::Vector2f(this->frames[0].size);
+        origin = size * 0.5f;
+        setDurations(std::vector<float>(this->frames.size(), frameSeconds));
+    }
+
+    void setDurations(std::vector<float> seconds)
+    {
+        durations = std::move(seconds);
+        durations.resize(frames.size(), durations.empty() ? 0.f : durations.back());
+        length = 0.f;
+        for (float d : durations) length += d;
+    }
+};
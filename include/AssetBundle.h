@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only view of a packed asset bundle, mapped into memory.
+//
+// A bundle is built offline from a config (tools/bundle_builder.cpp) and
+// holds everything already decoded: RGBA pixels, raw font files, 16-bit PCM
+// and the config lines that are not asset files (animations, atlas, ...).
+// Layout: Header, Entry[count], string table, then 16-byte aligned data.
+// Nothing is parsed or decoded at load; consumers upload straight from the
+// mapped bytes.
+class AssetBundle
+{
+public:
+
+    enum class Kind : std::uint32_t { Texture = 1, Font = 2, Sound = 3, Config = 4 };
+
+    struct Header
+    {
+        char          magic[8];          // "SFBNDL\0\0"
+        std::uint32_t version;
+        std::uint32_t entryCount;
+        std::uint64_t stringsOffset;
+        std::uint64_t stringsSize;
+    };
+
+    // texture: a = width, b = height, c = smooth
+    // sound:   a = channels, b = sample rate, c = byte offset of the samples
+    //          (data starts with one SoundChannel value per channel)
+    struct Entry
+    {
+        Kind          kind;
+        std::uint32_t name;              // string table offsets, NUL terminated
+        std::uint32_t path;              // original source file
+        std::uint32_t a, b, c;
+        std::uint64_t offset;            // from the start of the file
+        std::uint64_t size;
+    };
+
+    static constexpr std::uint32_t VERSION = 1;
+
+    // entry description used by write(); data is copied into the bundle
+    struct Item
+    {
+        Kind                      kind = Kind::Config;
+        std::string               name;
+        std::string               path;
+        std::uint32_t             a = 0, b = 0, c = 0;
+        std::vector<std::uint8_t> data;
+    };
+
+private:
+
+    const std::uint8_t * m_data = nullptr;
+    std::size_t          m_size = 0;
+#ifdef _WIN32
+    void *               m_file    = nullptr;
+    void *               m_mapping = nullptr;
+#else
+    int                  m_fd      = -1;
+#endif
+
+public:
+
+    AssetBundle() = default;
+    ~AssetBundle();
+
+    AssetBundle(const AssetBundle &) = delete;
+    AssetBundle & operator=(const AssetBundle &) = delete;
+
+    bool open(const std::string & path);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    std::size_t            entryCount() const;
+    const Entry &          entry(std::size_t i) const;
+    std::string_view       string(std::uint32_t offset) const;
+    const std::uint8_t *   data(const Entry & e) const { return m_data + e.offset; }
+
+    // writes a bundle file; used by the offline builder
+    static bool write(const std::string & path, const std::vector<Item> & items);
+
+    // true if the file starts with the bundle magic
+    static bool isBundle(const std::string & path);
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Typed index into one of Assets' tables. Names are resolved to ids once, at
+// load or scene setup; lookups by id are a bounds check and an array index.
+// Index 0 is the table's fallback entry, so every id is safe to look up.
+template <class Tag>
+struct AssetId
+{
+    std::uint32_t index = 0;
+
+    constexpr AssetId() = default;
+    constexpr explicit AssetId(std::uint32_t i) : index(i) {}
+
+    constexpr explicit operator bool() const { return index != 0; }
+    friend constexpr bool operator==(AssetId, AssetId) = default;
+};
+
+using TextureId = AssetId<struct TextureTag>;
+using FontId    = AssetId<struct FontTag>;
+using SoundId   = AssetId<struct SoundTag>;
+using AnimId    = AssetId<struct AnimTag>;
+
+// Named storage with stable addresses: replacing an entry keeps its id and
+// its address, so references handed out earlier stay valid.
+template <class T, class Id>
+class AssetTable
+{
+    std::deque<T>                       m_items{ T{} };
+    std::unordered_map<std::string, Id> m_ids;
+#ifndef NDEBUG
+    std::vector<std::string>            m_names{ "<missing>" };   // id -> name, for debugging only
+#endif
+
+public:
+
+    Id set(const std::string & name, T value)
+    {
+        auto [it, added] = m_ids.try_emplace(name, Id{ static_cast<std::uint32_t>(m_items.size()) });
+        if (added)
+        {
+            m_items.push_back(std::move(value));
+#ifndef NDEBUG
+            m_names.push_back(name);
+#endif
+        }
+        else
+        {
+            m_items[it->second.index] = std::move(value);
+        }
+        return it->second;
+    }
+
+    Id find(const std::string & name) const
+    {
+        auto it = m_ids.find(name);
+        return it == m_ids.end() ? Id{} : it->second;
+    }
+
+    const T & get(Id id) const { return id.index < m_items.size() ? m_items[id.index] : m_items[0]; }
+    T &       get(Id id)       { return id.index < m_items.size() ? m_items[id.index] : m_items[0]; }
+
+    const char * name(Id id) const
+    {
+#ifndef NDEBUG
+        if (id.index < m_names.size()) return m_names[id.index].c_str();
+#endif
+        (void)id;
+        return "";
+    }
+
+    std::size_t size() const { return m_items.size(); }
+    auto begin()       { return m_items.begin(); }
+    auto end()         { return m_items.end(); }
+};
@@ -1,34 +1,160 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
+#include <optional>
 #include <unordered_map>
 #include <string>
 #include <vector>
-#include "Animation.h"
+#include "AnimationClip.h"
+#include "AssetBundle.h"
+#include "AssetTable.h"
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include "ThreadPool.h"
 
 class Assets {
-    std::unordered_map<std::string, sf::Texture>     m_textures;
-    std::unordered_map<std::string, sf::Font>        m_fonts;
-    std::unordered_map<std::string, sf::SoundBuffer> m_sounds;
-    std::unordered_map<std::string, Animation>       m_anims;
+    // declared first: fonts opened from the bundle read its mapping until destroyed
+    AssetBundle                                      m_bundle;
+    AssetTable<sf::Texture, TextureId>               m_textures;
+    TextureCache                                     m_textureCache;   // after m_textures: points into it
+    AssetTable<sf::Font, FontId>                     m_fonts;
+    AssetTable<sf::SoundBuffer, SoundId>             m_sounds;
+    AssetTable<AnimationClip, AnimId>                m_anims;
+
+    // frameClip cache, keyed without strings so spawn paths never hash names
+    struct FrameKey {
+        std::uint32_t clip;
+        int           x, y, w, h;
+        bool operator==(const FrameKey&) const = default;
+    };
+    struct FrameKeyHash {
+        std::size_t operator()(const FrameKey& k) const {
+            std::uint64_t h = k.clip;
+            for (int v : { k.x, k.y, k.w, k.h }) h = h * 0x9E3779B97F4A7C15ull + static_cast<std::uint32_t>(v);
+            return static_cast<std::size_t>(h ^ (h >> 29));
+        }
+    };
+    std::unordered_map<FrameKey, AnimId, FrameKeyHash> m_frameClips;
+
+    std::unordered_map<std::string, TextureAtlas::Source> m_textureSources;
+    TextureAtlas                                     m_atlas;
+
+    // one config line waiting to be applied; textures and sounds decode on the pool meanwhile
+    struct Pending {
+        std::string line;
+        std::size_t ln = 0;
+        std::string name, path;
+        unsigned    atlasPage = 0;      // an Atlas line; packs on the pool once it is next
+        std::future<std::optional<sf::Image>>       image;
+        std::future<std::optional<sf::SoundBuffer>> sound;
+        std::future<TextureAtlas::Packed>           atlas;
+    };
+
+    std::unique_ptr<ThreadPool>                      m_loader;
+    std::deque<Pending>                              m_pending;
+    std::size_t                                      m_loadTotal = 0;
+    bool                                             m_headless = false;
+    std::size_t                                      m_loadDone  = 0;
+    std::string                                      m_prefabsPath;
+
+    TextureId storeTexture(const std::string& name, sf::Texture texture, TextureCache::Source source);
+    void mapToAtlas(AnimationClip& clip) const;
+    std::vector<TextureAtlas::Source> atlasSources() const;
+    bool useAtlas(TextureAtlas::Packed packed);
+    void applyLine(const std::string& line, std::size_t ln);
+    void apply(Pending& p);
+    bool pump(bool block, std::chrono::microseconds budget);
 
 public:
     void loadTexture(const std::string& name, const std::string& path, bool smooth=true);
     void loadFont(const std::string& name, const std::string& path);
     void loadSound(const std::string& name, const std::string& path);
-    void loadFromFile(const std::string& path);
+    void loadFromFile(const std::string& path);     // beginLoad + finishLoad
+
+    // Headless: set before loading. Images are decoded for their sizes (clips
+    // and collision boxes need them) but nothing is uploaded; textures stay
+    // empty, residency calls do nothing and Atlas lines are skipped.
+    void setHeadless(bool headless) { m_headless = headless; }
+    bool headless() const           { return m_headless; }
+
+    // Reads the config and starts decoding every texture and sound on a thread
+    // pool. Fonts are opened right away (glyphs load lazily), so text works as
+    // soon as this returns. Everything else is applied in config order by
+    // updateLoad on the calling thread, which also does the GPU uploads. An
+    // Atlas line is packed on the pool too; only its page upload waits here.
+    bool  beginLoad(const std::string& path);
+    bool  updateLoad(std::chrono::microseconds budget = std::chrono::milliseconds(4));
+    void  finishLoad();
+
+    // loads a bundle made by tools/bundle_builder: uploads straight from the
+    // mapped file, then applies its config lines; only one bundle per Assets
+    bool  loadBundle(const std::string& path);
+
+    // the config's Prefabs line; known as soon as beginLoad or loadBundle returns
+    const std::string& prefabsPath() const { return m_prefabsPath; }
+
+    bool  loaded()       const { return m_pending.empty(); }
+    float loadProgress() const { return m_loadTotal ? static_cast<float>(m_loadDone) / m_loadTotal : 1.f; }
+
+    // Name -> id resolution hashes a string; do it once at load or scene setup
+    // and keep the id. Ids are stable for the lifetime of Assets; a missing
+    // name gives the empty id, which looks up a harmless fallback.
+    TextureId getTextureId  (const std::string& n) const;
+    FontId    getFontId     (const std::string& n) const;
+    SoundId   getSoundId    (const std::string& n) const;
+    SoundId   findSoundId   (const std::string& n) const { return m_sounds.find(n); }
+    AnimId    getAnimationId(const std::string& n) const;
+    AnimId    findAnimationId(const std::string& n) const;   // no warning when missing
+
+    // may be evicted (empty) under a texture budget; drawing code calls useTexture first
+    const sf::Texture&     getTexture  (TextureId id) const { return m_textures.get(id); }
+    const sf::Font&        getFont     (FontId id)    const { return m_fonts.get(id); }
+    const sf::SoundBuffer& getSound    (SoundId id)   const { return m_sounds.get(id); }
+    const AnimationClip&   getAnimation(AnimId id)    const { return m_anims.get(id); }
+
+    const sf::Texture&     getTexture   (const std::string& n) const { return getTexture(getTextureId(n)); }
+    const sf::Font&        getFont      (const std::string& n) const { return getFont(getFontId(n)); }
+    const sf::SoundBuffer& getSound     (const std::string& n) const { return getSound(getSoundId(n)); }
+    const AnimationClip&   getAnimation (const std::string& n) const { return getAnimation(getAnimationId(n)); }
+
+    // names are only kept in debug builds; release builds return ""
+    const char* debugName(TextureId id) const { return m_textures.name(id); }
+    const char* debugName(FontId id)    const { return m_fonts.name(id); }
+    const char* debugName(SoundId id)   const { return m_sounds.name(id); }
+    const char* debugName(AnimId id)    const { return m_anims.name(id); }
+
+    // Texture residency. With a budget set (bytes, 0 = unlimited, also the
+    // "TextureBudget megabytes" config line) textures are evicted least
+    // recently used first and reloaded by useTexture on their next draw.
+    // prefetch starts loading ahead of time, e.g. for a level about to start.
+    void useTexture(TextureId id)          { if (!m_headless) m_textureCache.use(id); }
+    void useTexture(const AnimationClip& c) { useTexture(c.textureId); }
+    void prefetch(TextureId id)            { if (!m_headless) m_textureCache.prefetch(id); }
+    void prefetch(AnimId id)               { prefetch(getAnimation(id).textureId); }
+    void updateResidency()                 { if (!m_headless) m_textureCache.update(); }
+    void setTextureBudget(std::size_t bytes);
+    const TextureCache::Stats& textureStats() const { return m_textureCache.stats(); }
+    TextureCache&              textureCache()       { return m_textureCache; }
+
+    // adds or replaces a clip by name
+    AnimId addAnimation(const AnimationClip& clip);
 
-    const sf::Texture&    tex(const std::string& name)   const { return m_textures.at(name); }
-    const sf::Font&       font(const std::string& name)  const { return m_fonts.at(name); }
-    const sf::SoundBuffer& snd(const std::string& name)  const { return m_sounds.at(name); }
+    // a one-frame clip showing rect (in source sheet coordinates) of clip's texture,
+    // created on first use and shared by everything that asks for the same rect
+    AnimId frameClip(AnimId clip, const sf::IntRect& rect);
 
-    const sf::Texture&     getTexture   (const std::string& n) const;
-    const sf::Font&        getFont      (const std::string& n) const;
-    const sf::SoundBuffer& getSound     (const std::string& n) const;
-    const Animation&       getAnimation (const std::string& n) const;
+    // pack only these sub-rects of a texture instead of the whole image
+    void addAtlasFrames(const std::string& texture, const std::vector<sf::IntRect>& frames);
 
-    void addAnimation(const std::string& name, const Animation& a) { m_anims[name]=a; }
-    const Animation& anim(const std::string& name) const { return m_anims.at(name); }
+    // packs every loaded texture into atlas pages and points clips at them;
+    // with a cache dir the packed pages are reused while the sources are unchanged;
+    // only the first call packs, later ones (a second Atlas line, a reload) are ignored
+    bool buildAtlas(unsigned pageSize = 2048, const std::string& cacheDir = "");
+    const TextureAtlas& atlas() const { return m_atlas; }
 
     std::vector<sf::IntRect> makeGridFrames(int frameW,int frameH,int cols,int rows,
                                             int startIndex,int endIndex,
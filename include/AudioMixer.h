@@ -0,0 +1,173 @@
+#pragma once
+
+#include "AssetTable.h"
+#include <SFML/Audio.hpp>
+#include <SFML/System.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Assets;
+
+// Where voices end up. The mixer decides what plays; a device only starts,
+// adjusts and stops a fixed number of hardware voices.
+class AudioDevice
+{
+public:
+
+    virtual ~AudioDevice() = default;
+
+    virtual std::size_t voiceCount() const = 0;
+
+    // volume 0..1, pan -1 (left) .. 1 (right)
+    virtual void start(std::size_t voice, const sf::SoundBuffer & buffer,
+                       float volume, float pan, float pitch, bool loop) = 0;
+    virtual void set(std::size_t voice, float volume, float pan) = 0;
+    virtual void stop(std::size_t voice) = 0;
+    virtual bool playing(std::size_t voice) const = 0;
+
+    // advances devices that keep their own clock (the null device)
+    virtual void update(float /*dt*/) {}
+};
+
+// Plays through SFML; every sf::Sound is created up front.
+class SfmlAudioDevice : public AudioDevice
+{
+    std::vector<sf::Sound> m_sounds;
+
+public:
+
+    explicit SfmlAudioDevice(std::size_t voices = 32);
+
+    std::size_t voiceCount() const override { return m_sounds.size(); }
+    void start(std::size_t voice, const sf::SoundBuffer & buffer,
+               float volume, float pan, float pitch, bool loop) override;
+    void set(std::size_t voice, float volume, float pan) override;
+    void stop(std::size_t voice) override;
+    bool playing(std::size_t voice) const override;
+};
+
+// No audio output: a voice "plays" for its buffer's duration, advanced by
+// update(dt). Used headless and anywhere there is no audio hardware.
+class NullAudioDevice : public AudioDevice
+{
+    struct Voice
+    {
+        float remaining = 0.f;     // seconds; < 0 loops forever
+        float volume    = 0.f;
+        float pan       = 0.f;
+    };
+
+    std::vector<Voice> m_voices;
+
+public:
+
+    explicit NullAudioDevice(std::size_t voices = 32) : m_voices(voices) {}
+
+    std::size_t voiceCount() const override { return m_voices.size(); }
+    void start(std::size_t voice, const sf::SoundBuffer & buffer,
+               float volume, float pan, float pitch, bool loop) override;
+    void set(std::size_t voice, float volume, float pan) override;
+    void stop(std::size_t voice) override;
+    bool playing(std::size_t voice) const override;
+    void update(float dt) override;
+
+    float volume(std::size_t voice) const { return m_voices[voice].volume; }
+    float pan(std::size_t voice)    const { return m_voices[voice].pan; }
+};
+
+// Fixed pool of voices shared by every sound the game plays.
+//
+// Each sound has a priority, an instance limit and a hearing range around
+// the listener (the camera). play() never allocates: a sound that would be
+// inaudible is culled, one over its instance limit replaces its own oldest
+// instance, and when the pool is full it steals the least important voice
+// (lowest priority, then quietest, then oldest) or is culled if everything
+// playing matters more.
+class AudioMixer
+{
+public:
+
+    struct SoundParams
+    {
+        int      priority     = 0;
+        unsigned maxInstances = 4;
+        float    volume       = 1.f;
+        float    minDistance  = 128.f;    // full volume inside this
+        float    maxDistance  = 1024.f;   // silent beyond this
+        float    pitch        = 1.f;
+        bool     loop         = false;
+    };
+
+    struct VoiceId
+    {
+        std::uint32_t index      = 0;
+        std::uint32_t generation = 0;    // 0 = no voice
+        explicit operator bool() const { return generation != 0; }
+    };
+
+    struct Stats
+    {
+        std::size_t played  = 0;
+        std::size_t stolen  = 0;
+        std::size_t culled  = 0;    // inaudible, or lost to more important voices
+        std::size_t limited = 0;    // replaced an instance of the same sound
+    };
+
+private:
+
+    struct Voice
+    {
+        SoundId       sound;
+        float         volume     = 0.f;   // before attenuation
+        float         gain       = 0.f;   // after attenuation
+        int           priority   = 0;
+        bool          positional = false;
+        bool          active     = false;
+        sf::Vector2f  position;
+        std::uint64_t started    = 0;
+        std::uint32_t generation = 0;
+    };
+
+    const Assets &               m_assets;
+    std::unique_ptr<AudioDevice> m_device;
+    std::vector<Voice>           m_voices;
+    std::vector<SoundParams>     m_params;      // by SoundId index
+    SoundParams                  m_defaults;
+    sf::Vector2f                 m_listener;
+    std::uint64_t                m_sequence = 0;
+    Stats                        m_stats;
+
+    const SoundParams & params(SoundId id) const;
+    float attenuation(const SoundParams & p, const sf::Vector2f & pos, float & pan) const;
+    VoiceId start(SoundId id, float volume, bool positional, const sf::Vector2f & pos);
+
+public:
+
+    AudioMixer(const Assets & assets, std::unique_ptr<AudioDevice> device);
+    ~AudioMixer();
+
+    AudioMixer(const AudioMixer &) = delete;
+    AudioMixer & operator=(const AudioMixer &) = delete;
+
+    void define(SoundId id, const SoundParams & params);
+
+    // non-positional, e.g. UI and the player's own sounds
+    VoiceId play(SoundId id, float volume = 1.f);
+    // attenuated and panned relative to the listener, updated as it moves
+    VoiceId playAt(SoundId id, const sf::Vector2f & position, float volume = 1.f);
+
+    void stop(VoiceId voice);
+    void stopAll();
+
+    void setListener(const sf::Vector2f & position) { m_listener = position; }
+
+    // once per frame: frees finished voices and re-attenuates positional ones
+    void update(float dt);
+
+    std::size_t  activeVoices() const;
+    AudioDevice& device() { return *m_device; }
+    const Stats& stats() const { return m_stats; }
+    void         resetStats() { m_stats = {}; }
+};
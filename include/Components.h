@@ -1,8 +1,10 @@
 #pragma once
 
 #include "Vec2.h"
-#include "Animation.h"
+#include "AnimationClip.h"
+#include "AssetTable.h"
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -70,6 +72,20 @@ public:
 
 
     CShape() = default;
+
+    // copies get their own shape, so prefab prototypes can be instantiated by copy
+    CShape(const CShape& o) : has(o.has), shape(clone(o.shape.get())) {}
+    CShape& operator=(const CShape& o) { if (this != &o) { has = o.has; shape = clone(o.shape.get()); } return *this; }
+    CShape(CShape&&) = default;
+    CShape& operator=(CShape&&) = default;
+
+    static std::unique_ptr<sf::Shape> clone(const sf::Shape* s) {
+        if (auto c = dynamic_cast<const sf::CircleShape*>(s))    return std::make_unique<sf::CircleShape>(*c);
+        if (auto r = dynamic_cast<const sf::RectangleShape*>(s)) return std::make_unique<sf::RectangleShape>(*r);
+        if (auto p = dynamic_cast<const sf::ConvexShape*>(s))    return std::make_unique<sf::ConvexShape>(*p);
+        return nullptr;
+    }
+
     sf::CircleShape*          asCircle()                  { return dynamic_cast<sf::CircleShape*>(shape.get()); }
     const sf::CircleShape*    asCircle() const            { return dynamic_cast<const sf::CircleShape*>(shape.get()); }
     sf::RectangleShape*       asRectangle()               { return dynamic_cast<sf::RectangleShape*>(shape.get()); }
@@ -151,18 +167,39 @@ public:
         : minX(xMin), minY(yMin), maxX(xMax), maxY(yMax), killOutOfBounds(kill) {}
 };
 
+// playhead into a shared AnimationClip (see Assets::getAnimationId)
 class CAnimation {
 public:
-    Animation   animation;
-    std::string name;
-    bool        repeat{true};
-    bool        has{false};
+    bool          has{false};
+    bool          repeat{true};
+    bool          ended{false};
+    std::uint16_t frame{0};
+    AnimId        clip;
+    float         elapsed{0.f};
 
     CAnimation() = default;
-    explicit CAnimation(const Animation& a, bool r = true)
-        : animation(a), repeat(r) {}
-    CAnimation(const Animation& a, const std::string& n, bool r = true)
-        : animation(a), name(n), repeat(r) {}
+    explicit CAnimation(AnimId c, bool r = true) : repeat(r), clip(c) {}
+
+    // switches clips, restarting only if it is a different one
+    void play(AnimId c) {
+        if (c == clip) return;
+        clip = c; frame = 0; elapsed = 0.f; ended = false;
+    }
+
+    void advance(const AnimationClip& c, float dt) {
+        if (ended || c.length <= 0.f) return;
+        elapsed += dt;
+        for (;;) {
+            const float d = c.durations[frame];
+            if (d <= 0.f || elapsed < d) break;
+            elapsed -= d;
+            if (frame + 1u < c.frames.size()) ++frame;
+            else if (repeat)                  frame = 0;
+            else { ended = true; elapsed = 0.f; break; }
+        }
+    }
+
+    const sf::IntRect& rect(const AnimationClip& c) const { return c.frames[frame < c.frames.size() ? frame : 0]; }
 };
 
 class CBoundingBox {
@@ -184,3 +221,25 @@ public:
     CGravity() = default;
     explicit CGravity(const Vec2& gv) : gravity(gv) {}
 };
+
+// render layer and depth within it (0 back .. 1 front), see RenderLayer
+class CLayer {
+public:
+    bool         has{false};
+    std::uint8_t layer{64};
+    float        depth{0.f};
+    CLayer() = default;
+    explicit CLayer(std::uint8_t l, float d = 0.f) : layer(l), depth(d) {}
+};
+
+// light source; radius in pixels. handle is the scene's light map id (0 = not registered)
+class CLight {
+public:
+    bool        has{false};
+    float       radius{256.f};
+    sf::Color   color{sf::Color::White};
+    float       intensity{1.f};
+    std::size_t handle{0};
+    CLight() = default;
+    CLight(float r, const sf::Color& c, float i = 1.f) : radius(r), color(c), intensity(i) {}
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "RenderFrame.h"
+#include "Vec2.h"
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <string_view>
+#include <vector>
+
+// Immediate-mode debug overlay. Calls only append vertices; everything
+// queued during a frame is drawn by flush() with one draw for all lines,
+// one for filled shapes and one per font page for text.
+class DebugDraw
+{
+    static constexpr char FIRST_GLYPH = 32;
+    static constexpr char LAST_GLYPH  = 126;
+
+    struct GlyphQuad
+    {
+        sf::FloatRect bounds;
+        sf::FloatRect texRect;
+        float         advance = 0.f;
+    };
+
+    // glyph layout for one font/size, rasterized once (under glyphMutex) and reused every frame
+    struct TextBatch
+    {
+        const sf::Font *    font    = nullptr;
+        unsigned            size    = 0;
+        const sf::Texture * texture = nullptr;
+        std::array<GlyphQuad, LAST_GLYPH - FIRST_GLYPH + 1> glyphs;
+        std::vector<sf::Vertex> vertices;
+    };
+
+    std::vector<sf::Vertex> m_lines;
+    std::vector<sf::Vertex> m_triangles;
+    std::vector<TextBatch>  m_text;
+    std::size_t             m_drawCalls = 0;
+
+    TextBatch & batchFor(const sf::Font & font, unsigned size);
+
+public:
+
+    void line(const Vec2 & a, const Vec2 & b, const sf::Color & color = sf::Color::White);
+    void rect(const Vec2 & topLeft, const Vec2 & size, const sf::Color & color = sf::Color::White);
+    void fillRect(const Vec2 & topLeft, const Vec2 & size, const sf::Color & color);
+    void circle(const Vec2 & center, float radius, const sf::Color & color = sf::Color::White,
+                int points = 16);
+
+    // printable ASCII only; top-left placement like sf::Text
+    void text(const sf::Font & font, unsigned size, const Vec2 & pos, std::string_view str,
+              const sf::Color & color = sf::Color::White);
+
+    void flush(RenderFrame & frame);
+    void clear();
+
+    std::size_t drawCalls() const;
+    void        resetStats();
+};
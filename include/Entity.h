@@ -14,7 +14,9 @@ typedef std::tuple<
     CAnimation,
     CGravity,
     CState,
-    CShape
+    CShape,
+    CLayer,
+    CLight
 > ComponentTuple;
 
 class Entity
@@ -29,6 +31,7 @@ class Entity
     // constructor is private so we can never create
     // entities outside the EntityManager which had friend access
     Entity(const size_t id, const std::string& tag);
+    Entity(const size_t id, const std::string& tag, const ComponentTuple& components);
 
 public:
 
@@ -14,6 +14,8 @@ class EntityManager
 private:
     EntityVec m_entities;
     EntityVec m_entitiesToAdd;
+    EntityVec m_entitiesAdded;
+    EntityVec m_entitiesRemoved;
     EntityMap m_entityMap;
     size_t    m_totalEntities = 0;
 
@@ -28,6 +30,19 @@ public:
 
     std::shared_ptr<Entity> addEntity(const std::string & tag);
 
+    // new entity whose components start as a copy of the prototype (see Prefabs)
+    std::shared_ptr<Entity> addEntity(const std::string & tag, const ComponentTuple & prototype);
+
+    // room for n more pending entities, so a batch spawn grows the queue once
+    void reserve(std::size_t n) { m_entitiesToAdd.reserve(m_entitiesToAdd.size() + n); }
+
     const EntityVec & getEntities() const;
     const EntityVec & getEntities(const std::string & tag) const;
+    const EntityMap & getEntityMap() const;
+
+    // entities that became live during the most recent update()
+    const EntityVec & getAddedEntities() const;
+
+    // entities erased during the most recent update(), so indexes can drop them in the same frame
+    const EntityVec & getRemovedEntities() const;
 };
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Screenshots and replay capture without stalling the frame.
+//
+// The drawing thread calls onFrame() after a frame is drawn. It only copies
+// the backbuffer into a pooled pixel buffer and queues it. PNG encoding and
+// file IO happen on a background encoder thread, which returns buffers to
+// the pool. In continuous mode every Nth frame is kept in a ring of reused
+// buffers, sized to fit a byte budget at the window's resolution.
+// dumpReplay() lends the ring's buffers to the encoder as-is; a lent slot
+// skips captures until its buffer comes back, so a dump never allocates a
+// second ring and the ring never holds more than the budget.
+class FrameCapture
+{
+    using Buffer = std::vector<std::uint8_t>;
+
+    struct Job
+    {
+        Buffer                pixels;
+        sf::Vector2u          size;
+        std::filesystem::path path;
+        std::size_t           ring = 0;     // ring generation the buffer is lent from; 0 = none
+    };
+
+    struct RingFrame
+    {
+        Buffer       pixels;
+        sf::Vector2u size;
+        bool         lent = false;          // pixels are with the encoder
+    };
+
+    // encoder thread and pool, guarded by m_mutex
+    std::mutex                    m_mutex;
+    std::condition_variable       m_wake;
+    std::condition_variable       m_idle;
+    std::deque<Job>               m_jobs;
+    std::vector<Buffer>           m_pool;
+    std::vector<Buffer>           m_returned;   // lent ring buffers the encoder is done with
+    std::size_t                   m_ringGeneration = 1;
+    std::thread                   m_encoder;
+    bool                          m_stop = false;
+    bool                          m_busy = false;
+
+    // requests from other threads
+    std::vector<std::filesystem::path> m_shotRequests;    // guarded by m_mutex
+    std::filesystem::path              m_dumpDir;         // guarded by m_mutex
+    std::atomic<bool>                  m_hasRequests{false};
+    std::atomic<unsigned>              m_every{0};        // 0 = continuous mode off
+    std::atomic<std::size_t>           m_ringBytes{0};
+
+    // drawing-thread state
+    std::vector<RingFrame>        m_ring;
+    std::size_t                   m_ringHead  = 0;
+    std::size_t                   m_ringCount = 0;
+    std::size_t                   m_frames    = 0;
+    std::size_t                   m_shotIndex = 0;
+    std::size_t                   m_dumpIndex = 0;
+
+    std::atomic<std::size_t>      m_captured{0};
+    std::atomic<std::size_t>      m_written{0};
+    std::atomic<std::size_t>      m_dropped{0};
+
+    bool   grab(sf::RenderWindow & window, Buffer & out, sf::Vector2u & size);
+    Buffer acquire();
+    void   queue(Job job, bool mayDrop);
+    void   encoderMain();
+
+public:
+
+    FrameCapture() = default;
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture &) = delete;
+    FrameCapture & operator=(const FrameCapture &) = delete;
+
+    // drawing thread, after the frame is drawn and before display()
+    void onFrame(sf::RenderWindow & window);
+
+    // any thread; an empty path picks screenshot_N.png
+    void requestScreenshot(const std::filesystem::path & path = {});
+
+    // keep every Nth frame, as many as fit in maxBytes; everyNth = 0 turns it off
+    void setContinuous(unsigned everyNth, std::size_t maxBytes);
+
+    // writes the buffered replay frames, oldest first, into dir
+    void dumpReplay(const std::filesystem::path & dir = "captures");
+
+    // waits until everything queued so far is written
+    void flush();
+
+    std::size_t captured() const { return m_captured.load(std::memory_order_relaxed); }
+    std::size_t written()  const { return m_written.load(std::memory_order_relaxed); }
+    std::size_t dropped()  const { return m_dropped.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Histogram.h"
+#include <chrono>
+#include <cstdint>
+
+// Holds the main loop to a fixed frame period.
+//
+// OS sleeps wake up late by anything up to a couple of milliseconds, so
+// wait() sleeps until a margin before the deadline and spins the rest. The
+// margin follows the worst recent oversleep. Deadlines advance by exactly one
+// period, so a late frame does not shift the ones after it. If the loop falls
+// more than a frame behind, the schedule restarts from now instead of
+// rushing to catch up.
+class FramePacer
+{
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats
+    {
+        Histogram     frameTime;      // ms between frame starts
+        Histogram     jitter;         // ms from the deadline to the actual frame start
+        std::uint64_t missed = 0;     // deadlines dropped after falling behind
+    };
+
+private:
+
+    Clock::duration   m_period{};
+    Clock::time_point m_deadline{};
+    Clock::time_point m_lastStart{};
+    Clock::duration   m_spin = std::chrono::microseconds(1000);   // spin margin before the deadline
+    bool              m_started = false;
+    Stats             m_stats;
+
+public:
+
+    // 0 = unpaced: wait() returns at once, frame times are still recorded
+    void setTargetFps(unsigned fps);
+    unsigned targetFps() const;
+
+    // blocks until the next frame should start; returns that start time
+    Clock::time_point wait();
+
+    const Stats & stats() const { return m_stats; }
+    void resetStats()           { m_stats = {}; }
+};
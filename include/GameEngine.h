@@ -1,9 +1,18 @@
 #pragma once
 
 #include "Assets.h"
+#include "AudioMixer.h"
+#include "FramePacer.h"
+#include "InputLog.h"
+#include "Prefabs.h"
+#include "Renderer.h"
 #include "Scene.h"
+#include "ThreadPool.h"
 
+#include <cstdint>
+#include <future>
 #include <memory>
+#include <vector>
 
 using SceneMap = std::map<std::string, std::shared_ptr<Scene>>;
 
@@ -12,34 +21,113 @@ class GameEngine
 
 protected:
 
+    enum class InputMode { Live, Record, Replay };
+
+    // a scene loading on the worker, swapped in once loaded and asked for
+    struct PendingScene
+    {
+        std::string            name;
+        std::shared_ptr<Scene> scene;
+        std::future<void>      loaded;          // valid once the worker has it
+        bool                   activate   = false;
+        bool                   endCurrent = false;
+    };
+
+    struct EndedScene
+    {
+        std::shared_ptr<Scene> scene;
+        std::uint64_t          frame;           // when it ended
+    };
+
+    bool                m_headless = false;
+    sf::Vector2u        m_size{1280, 720};   // the window's, or the virtual screen when headless
     sf::RenderWindow    m_window;
+    Renderer            m_renderer{m_window};
+    FramePacer          m_pacer;
     Assets              m_assets;
+    AudioMixer          m_audio;             // after m_assets: plays its buffers
+    Prefabs             m_prefabs;
     std::string         m_currentScene;
     SceneMap            m_sceneMap;
     size_t              m_simulationSpeed = 1;
     bool                m_running = true;
+    bool                m_threadedRender = true;
+    bool                m_replayCapture = false;    // F11
+    std::uint64_t       m_frame = 0;
+    InputMode           m_inputMode = InputMode::Live;
+    InputLog            m_inputLog;
+    std::string         m_inputLogPath;
+    std::vector<float>  m_frameTimes;       // milliseconds, collected while replaying
+    std::vector<PendingScene> m_pendingScenes;
+    std::vector<EndedScene>   m_endedScenes;
+    std::unique_ptr<ThreadPool> m_sceneLoader;  // last: joined before the scenes it loads go away
 
     void init(const std::string & path);
     void update();
+    void updateLoading();
 
     void sUserInput();
+    void updateScenes();
+    void startLoad(PendingScene & pending);
+    void setCurrentScene(const std::string & sceneName, std::shared_ptr<Scene> scene, bool endCurrentScene);
 
     std::shared_ptr<Scene> currentScene();
 
 public:
 
-    GameEngine(const std::string & path);
+    // every simulated frame advances the game by FRAME_DT. Live play is paced
+    // to TARGET_FPS; replays, headless runs and simulate() run unpaced.
+    static constexpr unsigned TARGET_FPS = 60;
+    static constexpr float    FRAME_DT   = 1.f / TARGET_FPS;
 
+    // headless: no window, renderer, GPU textures or audio device; scenes
+    // still load and simulate, driven by run() or simulate()
+    GameEngine(const std::string & path, bool headless = false);
+
+    // loads (Scene::load) and starts the scene right away
     void changeScene(const std::string & sceneName, std::shared_ptr<Scene> scene, bool endCurrentScene = false);
 
+    // Starts Scene::load on a worker thread once the assets have finished
+    // loading; the current scene keeps running meanwhile. changeScene(name)
+    // then swaps it in, immediately if it is ready or else as soon as it is.
+    void preloadScene(const std::string & sceneName, std::shared_ptr<Scene> scene);
+    void changeScene(const std::string & sceneName, bool endCurrentScene = false);
+    bool sceneReady(const std::string & sceneName) const;
+
     void quit();
     void run();
 
+    // steps frames without drawing or pacing, as fast as the CPU allows
+    void simulate(std::size_t frames);
+
+    // Record logs every dispatched action to path when run() returns. Replay
+    // ignores keyboard actions, feeds the log back on the recorded frames,
+    // runs unthrottled and quits at the end of the session, printing frame
+    // time stats. Call either before run().
+    bool recordInput(const std::string & path);
+    bool replayInput(const std::string & path);
+
+    // recording or replaying: scenes must not let wall-clock timing change the simulation
+    bool deterministic() const { return m_inputMode != InputMode::Live; }
+    std::uint64_t frame() const { return m_frame; }
+    const std::vector<float>& frameTimes() const { return m_frameTimes; }
+
+    // scenes record into this during sRender(); it is drawn after the update
+    RenderFrame& renderFrame() { return m_renderer.frame(); }
+    Renderer& renderer() { return m_renderer; }
+    FramePacer& pacer() { return m_pacer; }
+    void setThreadedRender(bool threaded) { m_threadedRender = threaded; }
+
+    // never created when headless; scenes use size() for layout
     sf::RenderWindow& window() { return m_window; }
     const sf::RenderWindow& window() const { return m_window; }
+    sf::Vector2u size() const { return m_headless ? m_size : m_window.getSize(); }
+    bool headless() const { return m_headless; }
     bool isRunning();
     Assets& assets() { return m_assets; }
     const Assets& assets() const { return m_assets; }
+    AudioMixer& audio() { return m_audio; }
+    const Prefabs& prefabs() const { return m_prefabs; }
     Assets& getAssets() { return m_assets; }
     const Assets& getAssets() const { return m_assets; }
 };
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-bucket histogram of millisecond timings: 0.1 ms buckets up to 100 ms,
+// plus one overflow bucket. Adding a sample is an increment, so it can run
+// every frame; percentiles are read from the bucket counts.
+class Histogram
+{
+public:
+
+    static constexpr std::size_t BUCKETS   = 1000;
+    static constexpr double      BUCKET_MS = 0.1;
+
+private:
+
+    std::array<std::uint32_t, BUCKETS + 1> m_counts{};
+    std::uint64_t m_samples = 0;
+    double        m_sum     = 0.0;
+    double        m_max     = 0.0;
+
+public:
+
+    void add(double ms)
+    {
+        ms = std::max(ms, 0.0);
+        ++m_counts[std::min(static_cast<std::size_t>(ms / BUCKET_MS), BUCKETS)];
+        ++m_samples;
+        m_sum += ms;
+        m_max  = std::max(m_max, ms);
+    }
+
+    void reset() { *this = Histogram{}; }
+
+    std::uint64_t samples() const { return m_samples; }
+    double        mean()    const { return m_samples ? m_sum / m_samples : 0.0; }
+    double        max()     const { return m_max; }
+
+    // upper edge of the bucket holding quantile q (0..1); the max for the overflow bucket
+    double percentile(double q) const
+    {
+        if (!m_samples) return 0.0;
+        const auto rank = static_cast<std::uint64_t>(q * (m_samples - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKETS; ++i)
+            if ((seen += m_counts[i]) >= rank) return (i + 1) * BUCKET_MS;
+        return m_max;
+    }
+
+    std::uint32_t bucket(std::size_t i) const { return m_counts[i]; }
+};
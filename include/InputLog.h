@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Action.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Recorded session of scene actions, keyed by engine frame number.
+//
+// Recording appends every action the engine dispatches; replay hands them
+// back on the same frames, so a session re-runs without live input. On disk
+// the action names are stored once and each event is two varints (frame
+// delta, name index and type), so long sessions stay small. Names are
+// re-interned on load, so logs survive builds that bind actions in a
+// different order.
+class InputLog
+{
+public:
+
+    struct Event
+    {
+        std::uint64_t frame;
+        ActionId      action;
+        ActionType    type;
+    };
+
+private:
+
+    std::vector<Event> m_events;
+    std::uint64_t      m_length = 0;      // frames in the session
+    std::size_t        m_cursor = 0;      // replay position
+
+public:
+
+    void clear() { m_events.clear(); m_length = 0; m_cursor = 0; }
+    void rewind() { m_cursor = 0; }
+
+    void record(std::uint64_t frame, const Action & action) { m_events.push_back({ frame, action.id(), action.type() }); }
+    void setLength(std::uint64_t frames) { m_length = frames; }
+
+    // the next recorded action due on or before frame, in recorded order
+    std::optional<Action> next(std::uint64_t frame)
+    {
+        if (m_cursor == m_events.size() || m_events[m_cursor].frame > frame) return std::nullopt;
+        const Event & e = m_events[m_cursor++];
+        return Action(e.action, e.type);
+    }
+
+    bool finished(std::uint64_t frame) const { return m_cursor == m_events.size() && frame >= m_length; }
+
+    std::uint64_t              length() const { return m_length; }
+    const std::vector<Event> & events() const { return m_events; }
+
+    bool save(const std::string & path) const;
+    bool load(const std::string & path);
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Everything a level file describes, with animation names stored once.
+// Records refer to names by index, so resolving a level's names to asset
+// ids costs one lookup per distinct name, not one per tile.
+struct LevelData
+{
+    struct Tile                            // Tile (grid cell) and Dec (pixels)
+    {
+        std::uint32_t anim;                // index into names
+        float         x, y;
+    };
+
+    struct Light
+    {
+        float         x, y;                // grid cell
+        float         radius;              // pixels
+        float         intensity;
+        std::uint8_t  r, g, b, a;
+    };
+
+    struct Player
+    {
+        float         x, y, cw, ch, speed, jump, maxSpeed, gravity;
+        std::uint32_t weapon;              // index into names
+        std::uint32_t present;
+    };
+
+    std::vector<std::string> names;
+    std::vector<Tile>        tiles;
+    std::vector<Tile>        decs;
+    std::vector<Light>       lights;
+    Player                   player{};
+};
+
+// Reads level files (format in README/README.txt):
+//   Tile   Animation GX GY
+//   Dec    Animation X Y
+//   Player GX GY CW CH SX SY SM GY Bullet
+//   Light  GX GY Radius R G B [Intensity]
+//
+// The text is tokenized in place (string_views into one buffer, numbers via
+// from_chars), then compiled into a binary cache next to the file,
+// "<level>.lvlc". The cache stores the source's size, mtime and hash; while
+// size and mtime match it is loaded without touching the text, by copying
+// the record arrays straight out of the file.
+class LevelLoader
+{
+public:
+
+    struct Info
+    {
+        bool        fromCache = false;
+        bool        cacheWritten = false;
+        double      milliseconds = 0.0;
+    };
+
+    static bool load(const std::string & path, LevelData & out, Info * info = nullptr);
+
+    // text only; errors name the file and line. Bad records are skipped and
+    // the rest is still read, but the result is false; such a level is not cached.
+    static bool parse(std::string_view text, const std::string & path, LevelData & out);
+
+    static std::string cachePath(const std::string & path) { return path + ".lvlc"; }
+};
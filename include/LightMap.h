@@ -0,0 +1,102 @@
+#pragma once
+
+#include "RenderFrame.h"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// CPU light map over the tile grid, one texel per cell.
+// Every light keeps its own shadowcast contribution, so moving, changing or
+// removing a light (or toggling an occluder inside its radius) only subtracts
+// the old contribution and adds the new one; untouched lights cost nothing.
+// Only a fixed-size window of cells around the view is held. Its storage
+// wraps around, so when the view moves on, the cells that scroll in are filled
+// from the lights' cached contributions and nothing else is touched; lights
+// outside the window are not cast until it reaches them. The result is an
+// RGBA image meant to be multiplied over the scene, re-uploaded by dirty rect.
+class LightMap
+{
+public:
+
+    using LightId = std::size_t;   // 0 is never a valid id
+
+    struct Light
+    {
+        sf::Vector2i cell;
+        int          radius    = 6;      // in cells
+        sf::Color    color     = sf::Color::White;
+        float        intensity = 1.f;
+
+        bool operator==(const Light &) const = default;
+    };
+
+private:
+
+    struct LightState
+    {
+        Light                     light;
+        Light                     applied;    // what is currently summed into m_accum
+        std::vector<std::int32_t> contrib;    // rgb per cell of the (2r+1)^2 square
+        bool                      dirty      = true;
+        bool                      hasApplied = false;
+    };
+
+    sf::Vector2f                                    m_cellSize;
+    sf::IntRect                                     m_window;          // cells held, around the view
+    sf::Color                                       m_ambient = sf::Color::White;
+    std::unordered_map<std::uint64_t, std::uint16_t> m_occluders;      // cell -> tile count
+    std::vector<std::uint8_t>                       m_opaque;          // window cells, wrapped (see index)
+    std::vector<std::int32_t>                       m_accum;           // rgb sum per window cell, wrapped
+    std::unordered_map<LightId, LightState>         m_lights;
+    LightId                                         m_nextId  = 1;
+    std::vector<sf::IntRect>                        m_dirty;           // cells to rewrite, inside m_window
+    std::shared_ptr<RenderImage>                    m_image;
+    std::uint64_t                                   m_slot;
+    std::size_t                                     m_cellsRelit = 0;
+
+    static std::uint64_t key(int cx, int cy);
+    static sf::IntRect   square(const Light & l);
+
+    bool        inWindow(int cx, int cy) const;
+    std::size_t index(int cx, int cy) const;
+    bool        opaque(int cx, int cy) const;
+    void markDirty(const sf::IntRect & cells);
+    void refresh(const sf::IntRect & cells);
+    void touchLights(const sf::Vector2i & cell);
+    void cast(LightState & s);
+    void castOctant(LightState & s, int row, float start, float end, int xx, int xy, int yx, int yy);
+    void lightCell(LightState & s, int dx, int dy);
+    void apply(const LightState & s, const Light & at, int sign, const sf::IntRect & clip);
+    void writePixels();
+
+public:
+
+    explicit LightMap(const sf::Vector2f & cellSize = {64.f, 64.f});
+
+    sf::Vector2i cellOf(const sf::Vector2f & world) const;
+
+    // cells holding at least one occluder block light; counted per tile
+    void addOccluder(const sf::Vector2i & cell);
+    void removeOccluder(const sf::Vector2i & cell);
+
+    LightId add(const Light & light);
+    void    set(LightId id, const Light & light);    // no-op when unchanged
+    void    remove(LightId id);
+    void    clear();
+
+    void setAmbient(const sf::Color & ambient);
+
+    // keeps area (world units, normally the view) inside the window, moving the
+    // window when area leaves it; the window is resized only if area's size changes
+    void follow(const sf::FloatRect & area);
+
+    // applies pending changes; true when the image changed
+    bool update();
+
+    std::shared_ptr<const RenderImage> image() const { return m_image; }
+    void        quad(sf::Vertex * out) const;        // 6 vertices over the window
+    std::size_t lightCount()  const;
+    std::size_t cellsRelit()  const;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "AssetTable.h"
+#include "EntityManager.h"
+#include <cstddef>
+#include <string>
+#include <utility>
+
+using PrefabId = AssetId<struct PrefabTag>;
+
+// Prototype entity: a tag and a ready-made component block. Instances start
+// as a copy of the block, so spawning costs one allocation and a copy
+// instead of an addComponent call (and its constructor) per component.
+struct Prefab
+{
+    std::string    tag;
+    ComponentTuple components;
+
+    // spawner settings from the config; the prototype uses the low end of each range
+    float          speedMin      = 0.f;   // pixels per frame
+    float          speedMax      = 0.f;
+    std::size_t    pointsMin     = 0;     // shape vertices
+    std::size_t    pointsMax     = 0;
+    float          childLifespan = 0.f;   // seconds, for the pieces an Enemy breaks into
+    float          interval      = 0.f;   // seconds between spawns
+
+    // same contract as Entity::addComponent, on the prototype
+    template <typename T, typename... TArgs>
+    T & add(TArgs&&... args)
+    {
+        auto & c = std::get<T>(components);
+        c = T(std::forward<TArgs>(args)...);
+        c.has = true;
+        return c;
+    }
+
+    template <typename T> T &       get()       { return std::get<T>(components); }
+    template <typename T> const T & get() const { return std::get<T>(components); }
+};
+
+// per-instance values laid over a prefab's prototype; a null array keeps the prototype's
+struct PrefabOverrides
+{
+    const Vec2 *        velocities = nullptr;
+    const float *       angles     = nullptr;
+    const std::size_t * points     = nullptr;   // circle shapes only
+    const sf::Color *   fills      = nullptr;
+};
+
+// Named prefabs, compiled from config lines at load or defined in code.
+//   Player SR CR S FR FG FB OR OG OB OT V
+//   Enemy  SR CR SMIN SMAX OR OG OB OT VMIN VMAX L SI
+//   Bullet SR CR S FR FG FB OR OG OB OT V L
+// (shape radius, collision radius, speed, fill and outline colour, outline
+// thickness, vertices; L is a lifespan and SI a spawn interval, in frames)
+// Other lines, like Window and Font, belong to other loaders and are skipped.
+class Prefabs
+{
+    AssetTable<Prefab, PrefabId> m_prefabs;
+
+public:
+
+    bool loadFromFile(const std::string & path);
+    bool parseLine(const std::string & line, std::size_t ln);
+
+    // adds or replaces a prefab; earlier ids and instances are unaffected
+    Prefab & define(const std::string & name, const std::string & tag);
+
+    PrefabId       find(const std::string & name) const { return m_prefabs.find(name); }
+    const Prefab & get(PrefabId id) const               { return m_prefabs.get(id); }
+    const char *   name(PrefabId id) const              { return m_prefabs.name(id); }
+
+    std::shared_ptr<Entity> spawn(EntityManager & entities, PrefabId id, const Vec2 & position) const;
+
+    // count instances at positions[0..count) in one go; out (optional) receives them
+    void spawn(EntityManager & entities, PrefabId id, std::size_t count, const Vec2 * positions,
+               const PrefabOverrides & overrides = {}, EntityVec * out = nullptr) const;
+
+private:
+
+    static void place(Entity & e, const Vec2 & position, const PrefabOverrides & overrides, std::size_t i);
+};
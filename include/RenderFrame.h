@@ -0,0 +1,112 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <variant>
+#include <vector>
+
+// Fonts rasterize glyphs into their page textures on first use, and the
+// render thread may be drawing from those textures. Anything that can add a
+// glyph (getGlyph for one not used before) holds this lock; the renderer
+// holds it while it executes a frame. Recording text only looks glyphs up
+// once they exist, so the common path never takes it.
+std::mutex & glyphMutex();
+
+// Vertex data that is built once and drawn for many frames (e.g. a baked
+// tile chunk). Meshes are immutable: changing one means making a new mesh,
+// so the renderer can key its GPU copy on id alone.
+struct StaticMesh
+{
+    std::uint64_t           id      = 0;
+    const sf::Texture *     texture = nullptr;
+    std::vector<sf::Vertex> vertices;
+
+    static std::uint64_t nextId();
+};
+
+// CPU pixels (RGBA) that the renderer mirrors into a texture. The slot names
+// the texture and stays the same across updates; a new version means the
+// renderer re-uploads, an unchanged one costs nothing. If the renderer still
+// holds version base, only the dirty rects are uploaded.
+struct RenderImage
+{
+    std::uint64_t             slot    = 0;
+    std::uint64_t             version = 0;
+    sf::Vector2u              size;
+    std::vector<std::uint8_t> pixels;
+    bool                      smooth   = true;
+    bool                      repeated = false;
+    std::uint64_t             base     = 0;   // version the dirty rects are relative to
+    std::vector<sf::IntRect>  dirty;          // pixels changed since base; empty = all
+
+    static std::uint64_t nextId();
+};
+
+// Everything needed to draw one frame, recorded by the simulation and then
+// handed to the renderer. Nothing in here points at mutable scene state,
+// so it can be drawn on another thread while the next frame is recorded.
+class RenderFrame
+{
+public:
+
+    using Shape = std::variant<sf::CircleShape, sf::RectangleShape, sf::ConvexShape>;
+
+    enum class Kind : std::uint8_t { View, Vertices, Mesh, Text, Shape, Image };
+
+    struct Command
+    {
+        Kind                kind      = Kind::Vertices;
+        sf::PrimitiveType   primitive = sf::PrimitiveType::Triangles;
+        const sf::Texture * texture   = nullptr;
+        sf::BlendMode       blend     = sf::BlendAlpha;
+        std::size_t         first     = 0;   // vertex offset, or index into views/meshes/texts/shapes
+        std::size_t         count     = 0;
+        std::size_t         resource  = 0;   // index into images for Kind::Image
+    };
+
+private:
+
+    std::vector<sf::Vertex>                        m_vertices;
+    std::vector<Command>                           m_commands;
+    std::vector<sf::View>                          m_views;
+    std::vector<std::shared_ptr<const StaticMesh>> m_meshes;
+    std::vector<sf::Text>                          m_texts;
+    std::vector<Shape>                             m_shapes;
+    std::vector<std::shared_ptr<const RenderImage>> m_images;
+    sf::Color                                      m_clearColor = sf::Color::Black;
+    std::size_t                                    m_number     = 0;
+    std::chrono::steady_clock::time_point          m_inputTime{};   // when the input this frame shows was read
+
+public:
+
+    void clear();
+
+    void setView(const sf::View & view);
+    void setClearColor(const sf::Color & c)   { m_clearColor = c; }
+    void setNumber(std::size_t n)             { m_number = n; }
+    void setInputTime(std::chrono::steady_clock::time_point t) { m_inputTime = t; }
+
+    // consecutive list draws with identical state are merged into one command
+    void draw(const sf::Vertex * vertices, std::size_t count, sf::PrimitiveType type,
+              const sf::Texture * texture = nullptr, const sf::BlendMode & blend = sf::BlendAlpha);
+    void draw(const std::shared_ptr<const StaticMesh> & mesh);
+    void draw(const sf::Text & text);
+    void draw(const sf::Shape & shape);
+    // quad is 6 vertices (two triangles) with texCoords in image pixels
+    void draw(const std::shared_ptr<const RenderImage> & image, const sf::Vertex * quad,
+              const sf::BlendMode & blend = sf::BlendAlpha);
+
+    const std::vector<sf::Vertex> &                        vertices()   const { return m_vertices; }
+    const std::vector<Command> &                           commands()   const { return m_commands; }
+    const std::vector<sf::View> &                          views()      const { return m_views; }
+    const std::vector<std::shared_ptr<const StaticMesh>> & meshes()     const { return m_meshes; }
+    const std::vector<sf::Text> &                          texts()      const { return m_texts; }
+    const std::vector<Shape> &                             shapes()     const { return m_shapes; }
+    const std::vector<std::shared_ptr<const RenderImage>> & images()    const { return m_images; }
+    const sf::Color &                                      clearColor() const { return m_clearColor; }
+    std::size_t                                            number()     const { return m_number; }
+    std::chrono::steady_clock::time_point                  inputTime()  const { return m_inputTime; }
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "RenderFrame.h"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Draw order within a frame. Lower layers are drawn first.
+enum class RenderLayer : std::uint8_t
+{
+    Background = 0,
+    Tiles      = 32,
+    Entities   = 64,
+    Foreground = 128,
+    Overlay    = 192,
+};
+
+// Per-frame list of draw commands, each tagged with a 64-bit sort key:
+//
+//   63..56 layer | 55..40 depth | 39..36 blend mode | 35..16 texture id | 15..0 unused
+//
+// flush() radix-sorts the keys and records the commands into a RenderFrame
+// in that order, so layering is explicit and draws sharing a texture and
+// blend mode end up adjacent and are merged into one draw call. The sort is
+// stable: commands with equal keys keep their submission order.
+class RenderQueue
+{
+    enum class Kind : std::uint8_t { Vertices, Mesh, Text, Shape };
+
+    struct Item
+    {
+        std::uint64_t       key   = 0;
+        Kind                kind  = Kind::Vertices;
+        sf::PrimitiveType   primitive = sf::PrimitiveType::Triangles;
+        const sf::Texture * texture = nullptr;
+        std::uint32_t       blend = 0;
+        std::uint32_t       first = 0;       // vertex offset, or index into meshes/texts/shapes
+        std::uint32_t       count = 0;
+    };
+
+    struct SortEntry
+    {
+        std::uint64_t key;
+        std::uint32_t item;
+    };
+
+    std::vector<Item>                                   m_items;
+    std::vector<sf::Vertex>                             m_vertices;
+    std::vector<std::shared_ptr<const StaticMesh>>      m_meshes;
+    std::vector<const sf::Text *>                       m_texts;
+    std::vector<const sf::Shape *>                      m_shapes;
+    std::vector<SortEntry>                              m_sorted;
+    std::vector<SortEntry>                              m_scratch;
+
+    std::unordered_map<const sf::Texture *, std::uint32_t> m_textureIds;
+    std::vector<sf::BlendMode>                          m_blendModes{ sf::BlendAlpha };
+
+    std::size_t                                         m_batches = 0;
+
+    std::uint32_t textureId(const sf::Texture * texture);
+    std::uint32_t blendId(const sf::BlendMode & blend);
+    void          push(Item item, RenderLayer layer, float depth);
+    void          sort();
+
+public:
+
+    static std::uint64_t makeKey(RenderLayer layer, float depth, std::uint32_t blend, std::uint32_t texture);
+
+    // writes the two triangles for one sprite quad into out[0..5], using the
+    // same transform order as sf::Transformable: origin -> scale -> rotate -> translate
+    static void makeQuad(sf::Vertex * out, const sf::IntRect & rect,
+                         const sf::Vector2f & origin, const sf::Vector2f & position,
+                         const sf::Vector2f & scale, float angleDegrees,
+                         const sf::Color & color = sf::Color::White);
+
+    // depth orders commands inside a layer, 0 (back) to 1 (front)
+    void drawSprite(RenderLayer layer, float depth, const sf::Texture & texture,
+                    const sf::IntRect & rect, const sf::Vector2f & origin,
+                    const sf::Vector2f & position, const sf::Vector2f & scale,
+                    float angleDegrees, const sf::Color & color = sf::Color::White,
+                    const sf::BlendMode & blend = sf::BlendAlpha);
+    void draw(RenderLayer layer, float depth, const sf::Vertex * vertices, std::size_t count,
+              sf::PrimitiveType type, const sf::Texture * texture = nullptr,
+              const sf::BlendMode & blend = sf::BlendAlpha);
+    void draw(RenderLayer layer, float depth, const std::shared_ptr<const StaticMesh> & mesh);
+
+    // text and shapes are referenced, not copied: they must outlive flush()
+    void draw(RenderLayer layer, float depth, const sf::Text & text);
+    void draw(RenderLayer layer, float depth, const sf::Shape & shape);
+
+    void flush(RenderFrame & frame);
+    void clear();
+
+    std::size_t size()    const { return m_items.size(); }
+    // state changes in the last flush, i.e. draw calls after merging
+    std::size_t batches() const { return m_batches; }
+};
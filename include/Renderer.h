@@ -0,0 +1,95 @@
+#pragma once
+
+#include "FrameCapture.h"
+#include "Histogram.h"
+#include "RenderFrame.h"
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// Draws recorded RenderFrames into the window.
+//
+// Two frames are double-buffered: the simulation records into the back
+// frame while the render thread draws the front one. submit() publishes the
+// back frame through an atomic slot and only waits if the render thread has
+// not yet picked up the previous frame, so a slow simulation frame and a
+// slow draw overlap instead of adding up. Without a thread, submit() draws
+// the frame immediately on the caller's thread.
+class Renderer
+{
+    struct MeshBuffer
+    {
+        sf::VertexBuffer buffer{ sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static };
+        std::size_t      lastUsed = 0;
+        bool             uploaded = false;
+    };
+
+    struct ImageTexture
+    {
+        sf::Texture   texture;
+        std::uint64_t version  = 0;
+        std::size_t   lastUsed = 0;
+        bool          valid    = false;
+    };
+
+    static constexpr int NO_FRAME = -1;
+    static constexpr int STOP     = -2;
+
+    sf::RenderWindow &                            m_window;
+    RenderFrame                                   m_frames[2];
+    int                                           m_back = 0;
+    std::size_t                                   m_frameNumber = 0;
+
+    std::thread                                   m_thread;
+    std::atomic<int>                              m_pending{NO_FRAME};
+    bool                                          m_threaded = false;
+
+    // render-thread state
+    std::unordered_map<std::uint64_t, MeshBuffer> m_meshBuffers;
+    std::unordered_map<std::uint64_t, ImageTexture> m_imageTextures;
+    std::size_t                                   m_executed = 0;
+    std::vector<std::uint8_t>                     m_uploadScratch;   // one dirty rect's rows
+    FrameCapture                                  m_capture;
+
+    std::atomic<std::size_t>                      m_drawCalls{0};
+    std::atomic<std::size_t>                      m_framesDrawn{0};
+
+    mutable std::mutex                            m_latencyMutex;
+    Histogram                                     m_latency;        // ms, input read -> display()
+
+    void threadMain();
+    void present(const RenderFrame & frame);
+    void execute(const RenderFrame & frame);
+    void drawMesh(const StaticMesh & mesh, const sf::RenderStates & states, std::size_t & calls);
+    const sf::Texture * imageTexture(const RenderImage & image);
+
+public:
+
+    explicit Renderer(sf::RenderWindow & window);
+    ~Renderer();
+
+    Renderer(const Renderer &) = delete;
+    Renderer & operator=(const Renderer &) = delete;
+
+    // threaded = true hands the window's GL context to a dedicated render thread
+    void start(bool threaded);
+    void stop();
+    bool isThreaded() const { return m_threaded; }
+
+    // the frame the simulation is currently recording into
+    RenderFrame & frame();
+    void          submit();
+
+    // screenshots and replay capture; grabbed after the next frame is drawn, encoded in the background
+    FrameCapture & capture() { return m_capture; }
+    void requestScreenshot() { m_capture.requestScreenshot(); }
+
+    std::size_t drawCalls()   const { return m_drawCalls.load(std::memory_order_relaxed); }
+    std::size_t framesDrawn() const { return m_framesDrawn.load(std::memory_order_relaxed); }
+
+    // input-to-present latency of frames with an input time (RenderFrame::setInputTime)
+    Histogram latency() const { std::lock_guard<std::mutex> lock(m_latencyMutex); return m_latency; }
+    void resetLatency()       { std::lock_guard<std::mutex> lock(m_latencyMutex); m_latency.reset(); }
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Action.h"
+#include "GameEngine.h"
+#include "Histogram.h"
+#include "FramePacer.h"
+#include "Scene.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct RoomServerConfig
+{
+    unsigned    tickRate = 60;      // fixed ticks per second; 0 = unpaced
+    std::size_t lanes    = 0;       // rooms are spread over this many threads; 0 = one per hardware thread
+    double      budgetMs = 1.0;     // default per-room tick budget
+};
+
+// Dedicated server hosting many independent matches ("rooms") in one process.
+//
+// Each room is its own headless Scene_Play world; rooms share only the
+// engine's assets and prefabs, which they read but never change, and one
+// thread for their chunk file IO. Rooms are
+// placed on lanes, one per core. A tick runs every lane in parallel (the
+// calling thread takes the last one) and each lane steps its rooms in turn,
+// so a room is only ever touched by one thread at a time.
+//
+// Placement follows measured cost: a new room goes to the lane with the least
+// load, and once a second the busiest lane hands a room to the quietest when
+// that lowers the peak. Every room has a tick budget; ticks over budget and
+// server ticks longer than the period are counted.
+class RoomServer
+{
+public:
+
+    using RoomId = std::uint32_t;
+    using Clock  = std::chrono::steady_clock;
+
+    struct RoomStats
+    {
+        Histogram     tickTime;         // ms per tick
+        std::uint64_t ticks    = 0;
+        std::uint64_t overruns = 0;     // ticks over the room's budget
+        double        load     = 0.0;   // smoothed ms per tick, drives placement
+    };
+
+    struct Stats
+    {
+        Histogram     tickTime;         // ms for a whole server tick, all lanes
+        std::uint64_t ticks        = 0;
+        std::uint64_t late         = 0; // server ticks longer than the period
+        std::uint64_t overruns     = 0; // room ticks over budget
+        std::uint64_t migrations   = 0; // rooms moved between lanes
+    };
+
+private:
+
+    struct Room
+    {
+        RoomId                 id = 0;
+        std::size_t            lane = 0;
+        double                 budgetMs = 0.0;
+        std::unique_ptr<Scene> scene;
+        std::vector<Action>    actions;     // queued by doAction, applied before the next tick
+        RoomStats              stats;
+    };
+
+    // written by its own thread during a tick; aligned so neighbours do not share a cache line
+    struct alignas(64) Lane
+    {
+        std::vector<std::unique_ptr<Room>> rooms;
+        double        load     = 0.0;       // sum of its rooms' loads
+        std::uint64_t overruns = 0;         // this tick
+    };
+
+    RoomServerConfig                m_config;
+    GameEngine                      m_engine;           // headless; owns the shared assets and prefabs
+    std::unique_ptr<ThreadPool>     m_worldIo;          // one chunk IO thread for every room; outlives them
+    std::vector<Lane>               m_lanes;
+    std::unordered_map<RoomId, Room*> m_rooms;
+    RoomId                          m_nextId = 1;
+    FramePacer                      m_pacer;
+    Stats                           m_stats;
+    std::atomic<bool>               m_running{false};
+    std::vector<std::future<void>>  m_pending;
+    std::unique_ptr<ThreadPool>     m_pool;             // last: joined before the rooms go away
+
+    void tickLane(Lane & lane);
+    void rebalance();
+    std::size_t quietestLane() const;
+
+public:
+
+    RoomServer(const std::string & configPath, const RoomServerConfig & config);
+    ~RoomServer();
+
+    RoomServer(const RoomServer &) = delete;
+    RoomServer & operator=(const RoomServer &) = delete;
+
+    // Builds and starts a room on the calling thread, between ticks. Each
+    // room keeps the chunks it changes in its own directory; rooms of the
+    // same level share its partition. budgetMs 0 = the default.
+    RoomId addRoom(const std::string & levelPath, double budgetMs = 0.0);
+    void   removeRoom(RoomId id);
+
+    // queued for the room's next tick; call between ticks
+    void doAction(RoomId id, const Action & action);
+
+    // one tick of every room, returning when all lanes are done
+    void tick();
+
+    // ticks at the fixed rate until stop() or, if given, that many ticks
+    void run(std::uint64_t ticks = 0);
+    void stop() { m_running = false; }
+
+    std::size_t roomCount() const { return m_rooms.size(); }
+    std::size_t laneCount() const { return m_lanes.size(); }
+    const RoomStats * roomStats(RoomId id) const;
+    const Stats & stats() const { return m_stats; }
+    GameEngine & engine() { return m_engine; }
+
+    // rooms one core could tick per period at the measured mean room cost
+    double roomsPerCore() const;
+    void printStats() const;
+};
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "Action.h"
+#include "DebugDraw.h"
 #include "EntityManager.h"
 
 #include <memory>
+#include <vector>
 
 class GameEngine;
 
@@ -15,25 +17,39 @@ protected:
     GameEngine *    m_game = nullptr;
     EntityManager   m_entityManager;
     ActionMap       m_actionMap;
+    std::vector<ActionHandler> m_actionHandlers;   // indexed by ActionId
     bool            m_paused = false;
     bool            m_hasEnded = false;
     size_t          m_currentFrame = 0;
+    DebugDraw       m_debugDraw;
 
 public:
 
     virtual ~Scene() = default;
     Scene(GameEngine * gameEngine);
 
+    // Setup that may run on a worker thread (GameEngine::preloadScene): parsing,
+    // building entities, reading asset tables. It must not touch the window,
+    // audio, action bindings or anything else the running scene uses, and must
+    // not add assets. init() follows on the main thread.
+    virtual void load() {}
     virtual void init() {}
     virtual void onEnd() = 0;
     virtual void update() = 0;
-    virtual void sDoAction(const Action & action) = 0;
-    void doAction(const Action& action) { sDoAction(action); }
+
+    // actions without a handler (see onAction) end up here
+    virtual void sDoAction(const Action &) {}
+
+    void doAction(const Action& action) {
+        if (action.id() < m_actionHandlers.size() && m_actionHandlers[action.id()]) m_actionHandlers[action.id()](action);
+        else sDoAction(action);
+    }
     virtual void sRender() = 0;
 
     void setPaused(bool paused);
     void simulate(const size_t frames);
-    void registerAction(int inputKey, const std::string& actionName);
+    ActionId registerAction(int inputKey, const std::string& actionName);
+    void onAction(const std::string& actionName, ActionHandler handler);
 
     size_t width() const;
     size_t height() const;
@@ -42,4 +58,5 @@ public:
     bool hasEnded() const;
     const ActionMap& getActionMap() const;
     void drawLine(const Vec2& p1, const Vec2& p2);
+    DebugDraw& debugDraw() { return m_debugDraw; }
 };
@@ -2,7 +2,7 @@
 
 #include "Scene.h"
 #include "EntityManager.h"
-#include <SFML/Graphics/Text.hpp>
+#include "TextLayer.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -10,16 +10,25 @@
 class Scene_Menu : public Scene
 {
 protected:
+    enum MenuItem : std::size_t { PLAY, QUIT };   // order of m_menuStrings
+
+
     std::string              m_title;
     std::vector<std::string> m_menuStrings;
     std::vector<std::string> m_levelPaths;
-    sf::Text                 m_menuText;
+    std::vector<bool>        m_preloaded;       // per menu item, its level has been handed to the engine
+    TextLayer                m_text;
+    TextLayer::LabelId       m_titleLabel = 0;
+    TextLayer::LabelId       m_loadingLabel = 0;
+    std::vector<TextLayer::LabelId> m_menuLabels;
     std::size_t              m_selectMenuIndex = 0;
 
     void init() override;
     void update() override;
     void onEnd() override;
-    void sDoAction(const Action& action) override;
+    void select();
+    void hover(std::size_t item);
+    void preload(std::size_t item);
 
 public:
     explicit Scene_Menu(GameEngine* gameEngine);
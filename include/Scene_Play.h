@@ -6,47 +6,105 @@
 #include <memory>
 
 #include "EntityManager.h"
+#include "SpatialGrid.h"
+#include "RenderQueue.h"
+#include "TileLayer.h"
+#include "LightMap.h"
+#include "LevelLoader.h"
+#include "Prefabs.h"
+#include "WorldStreamer.h"
 
 class Scene_Play : public Scene
 {
     struct PlayerConfig
     {
-        float X, Y, CX, CY, SPEED, MAXSPEED, JUMP, GRAVITY;
+        // defaults used until a level's Player record says otherwise (grid cells, pixels)
+        float X = 3.f, Y = 5.f, CX = 48.f, CY = 48.f, SPEED = 0.f, MAXSPEED = 0.f, JUMP = 0.f, GRAVITY = 0.f;
         std::string WEAPON;
     };
 
+    // clip ids the scene spawns with, resolved once in init(); empty if the config lacks one
+    struct AnimIds
+    {
+        AnimId idle, stand, brick, blocksSheet, air, run;
+    };
+
 public:
 
-    Scene_Play(GameEngine* gameEngine, const std::string& levelPath);
+    struct RenderStats
+    {
+        std::size_t total     = 0;
+        std::size_t visible   = 0;
+        std::size_t culled    = 0;
+        std::size_t quads     = 0;
+        std::size_t drawCalls = 0;
+        std::size_t chunks    = 0;
+        std::size_t rebakes   = 0;
+        std::size_t relit     = 0;
+    };
+
+    // worldDir: where chunks changed while playing are kept; defaults to the level path + ".world"
+    // worldIo: a single-threaded pool for chunk IO shared between scenes; by default the scene has its own
+    Scene_Play(GameEngine* gameEngine, const std::string& levelPath, const std::string& worldDir = "",
+               ThreadPool* worldIo = nullptr);
     void sRender() override;
     void onEnd() override;
-    void sDoAction(const Action& action) override;
     void update() override;
 
+    const RenderStats& renderStats() const { return m_renderStats; }
+
 protected:
 
     std::shared_ptr<Entity> m_player;
     std::string             m_levelPath;
+    std::string             m_worldDir;
+    ThreadPool*             m_worldIo = nullptr;
     PlayerConfig            m_playerConfig;
+    AnimIds                 m_anims;
+    Prefabs                 m_prefabs;          // built from the level; the engine's come from its config
+    PrefabId                m_playerPrefab;
+    PrefabId                m_bulletPrefab;
+    SoundId                 m_breakSound;
+    bool                    m_levelLoaded = false;
     bool                    m_drawTextures = true;
     bool                    m_drawCollision = false;
     bool                    m_drawGrid = false;
+    bool                    m_drawLighting = true;
     sf::Vector2f            m_gridSize = {64, 64};
     sf::Text                m_gridText;
+    RenderQueue             m_renderQueue;
+    TileLayer               m_tileLayer;
+    SpatialGrid             m_staticIndex;
+    LightMap                m_lightMap;
+    EntityVec               m_lights;
+    WorldStreamer           m_world;
+    EntityVec               m_visible;
+    EntityVec               m_debugEntities;
+    RenderStats             m_renderStats;
+    float                   m_cullMargin = 64.f;
     float                   m_moveSpeed = 4.0f;
 
     Vec2 gridToMidPixel(float gridX, float gridY,
                         std::shared_ptr<Entity> entity = nullptr);
 
+    void load() override;
     void init() override;
 
-    void loadLevel(const std::string & filename);
+    bool loadLevel(const std::string & filename);
     void spawnBullet(std::shared_ptr<Entity> entity);
     void spawnPlayer();
-    void spawnBlock(float px, float py, int col, int row, float scale);
+    void spawnBlocks(const Vec2 * positions, std::size_t count, int col, int row, float scale);
+    void spawnChunk(WorldStreamer::Key key, const WorldStreamer::ChunkData & data);
+    WorldStreamer::Record record(const Entity & e, WorldStreamer::ChunkData & data) const;
+    bool isStreamed(const Entity & e) const;
+    void removeStatic(const std::shared_ptr<Entity> & e);
+    sf::View camera() const;
     void sMovement();
     void sLifespan();
     void sCollision();
     void sDebug();
     void sAnimation();
+    void sSpatialIndex();
+    void sStreaming();
+    void sLighting();
 };
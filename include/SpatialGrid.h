@@ -0,0 +1,47 @@
+#pragma once
+
+#include "EntityManager.h"
+#include <SFML/Graphics/Rect.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Uniform grid over world space used to find the entities overlapping a
+// rectangle without walking every entity in the level.
+// The owner removes destroyed entities (see EntityManager::getRemovedEntities);
+// until then queries skip them.
+class SpatialGrid
+{
+    struct Record
+    {
+        std::shared_ptr<Entity> entity;
+        sf::FloatRect           bounds;
+        int                     x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+        std::size_t             stamp = 0;
+    };
+
+    float                                             m_cellSize;
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> m_cells;
+    std::unordered_map<std::size_t, Record>           m_records;
+    std::size_t                                       m_stamp = 0;
+
+    static std::uint64_t key(int cx, int cy);
+    int  cellOf(float v) const;
+    void link(std::size_t id, const Record & r);
+    void unlink(std::size_t id, const Record & r);
+
+public:
+
+    explicit SpatialGrid(float cellSize = 256.f);
+
+    // inserts the entity, or moves it if it is already indexed
+    void insert(const std::shared_ptr<Entity> & entity, const sf::FloatRect & bounds);
+    void remove(std::size_t id);
+    void clear();
+
+    // appends every live entity whose bounds overlap area to out
+    void query(const sf::FloatRect & area, EntityVec & out);
+
+    std::size_t size()     const;
+    float       cellSize() const;
+};
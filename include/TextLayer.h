@@ -0,0 +1,95 @@
+#pragma once
+
+#include "RenderFrame.h"
+#include "Vec2.h"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Retained-mode text for menus and HUDs.
+// A label's glyph layout is built once and only redone when its string, font,
+// size or style changes; moving or recolouring it just rebuilds its page.
+// Each font page (font + character size) is one cached vertex batch, so a
+// frame where nothing changed costs one draw per page and no layout work.
+// Labels draw in page order, so overlapping labels should share a page.
+// Printable ASCII is rasterized when a page is created; layouts that need
+// other glyphs add them under glyphMutex (see RenderFrame.h).
+class TextLayer
+{
+public:
+
+    using LabelId = std::size_t;   // 0 is never a valid id
+
+private:
+
+    struct Label
+    {
+        const sf::Font *        font   = nullptr;
+        unsigned                size   = 0;
+        std::uint32_t           style  = sf::Text::Regular;
+        std::string             string;
+        Vec2                    pos;
+        sf::Color               color  = sf::Color::White;
+        bool                    visible = true;
+        bool                    dirty   = true;    // layout needs rebuilding
+        std::vector<sf::Vertex> layout;            // local coordinates, white
+        sf::FloatRect           bounds;            // local
+    };
+
+    struct Page
+    {
+        const sf::Font *        font    = nullptr;
+        unsigned                size    = 0;
+        const sf::Texture *     texture = nullptr;
+        std::vector<LabelId>    labels;
+        std::vector<sf::Vertex> vertices;
+        std::unordered_set<std::uint64_t> glyphs;   // rasterized beyond printable ASCII: codepoint << 1 | bold
+        bool                    dirty = true;
+    };
+
+    std::unordered_map<LabelId, Label> m_labels;
+    std::vector<Page>                  m_pages;
+    LabelId                            m_nextId       = 1;
+    std::size_t                        m_layouts      = 0;
+    std::size_t                        m_pageRebuilds = 0;
+    std::size_t                        m_drawCalls    = 0;
+
+    Page & pageFor(const sf::Font & font, unsigned size);
+    Page * findPage(const Label & label);
+    void   touch(const Label & label);
+    void   detach(LabelId id, const Label & label);
+    bool   rasterized(Page & page, std::string_view str, bool bold);
+    void   layout(Label & label);
+    void   rebuild(Page & page);
+
+public:
+
+    LabelId add(const sf::Font & font, unsigned size, std::string_view str = {},
+                const Vec2 & pos = {0.f, 0.f}, const sf::Color & color = sf::Color::White,
+                std::uint32_t style = sf::Text::Regular);
+    void    remove(LabelId id);
+    void    clear();
+
+    // setters are no-ops when the value is unchanged, so calling them every frame is fine
+    void setString(LabelId id, std::string_view str);
+    void setNumber(LabelId id, long long value);    // formats without allocating
+    void setFont(LabelId id, const sf::Font & font, unsigned size);
+    void setStyle(LabelId id, std::uint32_t style);
+    void setPosition(LabelId id, const Vec2 & pos);
+    void setColor(LabelId id, const sf::Color & color);
+    void setVisible(LabelId id, bool visible);
+
+    // in world coordinates; lays the label out if needed
+    sf::FloatRect bounds(LabelId id);
+
+    void draw(RenderFrame & frame);
+
+    std::size_t layouts()      const;   // label layouts since resetStats
+    std::size_t pageRebuilds() const;
+    std::size_t drawCalls()    const;
+    void        resetStats();
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Packs sub-rectangles of source images into a few large texture pages.
+// All regions of one source texture land on the same page, so anything
+// drawn from that texture keeps using a single texture after remapping.
+class TextureAtlas
+{
+public:
+
+    struct Source
+    {
+        std::string              name;
+        std::string              path;
+        const std::uint8_t *     pixels = nullptr;  // RGBA already in memory (a bundle); used instead of path
+        sf::Vector2u             size;
+        bool                     smooth = true;
+        std::vector<sf::IntRect> rects;        // empty = the whole image
+    };
+
+    struct Region
+    {
+        sf::IntRect source;
+        sf::IntRect rect;
+    };
+
+    struct Mapping
+    {
+        const sf::Texture * texture = nullptr;
+        sf::IntRect         rect;
+    };
+
+    struct Entry
+    {
+        std::size_t         page = 0;
+        std::vector<Region> regions;
+    };
+
+    // the CPU half of a build: page images and where every region went
+    struct Packed
+    {
+        std::vector<sf::Image>                 images;
+        std::vector<bool>                      smooth;
+        std::unordered_map<std::string, Entry> entries;
+    };
+
+private:
+
+    std::vector<sf::Texture>               m_pages;
+    std::unordered_map<std::string, Entry> m_entries;
+
+    static bool loadCache(const std::string & dir, const std::string & signature, Packed & out);
+    static void saveCache(const std::string & dir, const std::string & signature, const Packed & packed);
+
+public:
+
+    // the requested page size clamped to what the GPU takes; needs the GL context
+    static unsigned pageSizeFor(unsigned requested);
+
+    // Decodes and packs the sources without touching the GPU, so it can run on
+    // a worker; pageSize comes from pageSizeFor. If cacheDir is set, a matching
+    // cache is read instead of packing, and a fresh pack is written back to it.
+    // The cache only saves decoding, so it is skipped when every source
+    // already has its pixels in memory.
+    static Packed pack(const std::vector<Source> & sources, unsigned pageSize,
+                       const std::string & cacheDir = "");
+
+    // uploads a pack as the atlas pages, replacing the current ones
+    bool upload(Packed packed);
+
+    // pack and upload in one go, on the calling thread
+    bool build(const std::vector<Source> & sources, unsigned pageSize,
+               const std::string & cacheDir = "");
+    void clear();
+
+    bool contains(const std::string & texture) const;
+
+    // maps a rect in source texture coordinates to its page and atlas rect
+    std::optional<Mapping> map(const std::string & texture, const sf::IntRect & rect) const;
+
+    std::size_t pageCount() const;
+    const sf::Texture & page(std::size_t i) const;
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "AssetTable.h"
+#include "ThreadPool.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Residency for the textures in Assets' table.
+//
+// Each texture is registered with where it can be reloaded from (an image
+// file or pixels in the mapped bundle). Drawing code calls use() for every
+// texture it submits; a texture that is not resident is loaded right there
+// (a miss). update() runs once per frame and evicts the least recently used
+// textures while the resident bytes exceed the budget. A texture used in the
+// last IN_FLIGHT_FRAMES frames is never evicted, since the render thread may
+// still be drawing with it. Evicting keeps the sf::Texture object, so its
+// address stays valid for clips and baked meshes; only its storage is freed.
+//
+// prefetch() decodes a file in the background so the first use is a hit.
+class TextureCache
+{
+public:
+
+    static constexpr std::size_t IN_FLIGHT_FRAMES = 2;
+
+    struct Source
+    {
+        std::string          path;                 // image file, if not bundled
+        const std::uint8_t * pixels = nullptr;     // RGBA in the bundle mapping
+        sf::Vector2u         size;
+        bool                 smooth = true;
+    };
+
+    struct Stats
+    {
+        std::size_t hits          = 0;
+        std::size_t misses        = 0;
+        std::size_t evictions     = 0;
+        std::size_t prefetches    = 0;
+        std::size_t residentBytes = 0;
+        std::size_t peakBytes     = 0;
+    };
+
+private:
+
+    struct Entry
+    {
+        sf::Texture *                         texture  = nullptr;
+        Source                                source;
+        std::size_t                           bytes    = 0;
+        std::size_t                           lastUsed = 0;
+        bool                                  resident = false;
+        std::future<std::optional<sf::Image>> decoding;
+    };
+
+    std::vector<Entry>          m_entries;          // by TextureId index
+    std::unique_ptr<ThreadPool> m_decoder;
+    std::size_t                 m_budget = 0;       // bytes, 0 = unlimited
+    std::size_t                 m_frame  = IN_FLIGHT_FRAMES;
+    Stats                       m_stats;
+
+    Entry * entry(TextureId id);
+    void    load(Entry & e);
+    void    upload(Entry & e, const sf::Image * image);
+    void    evict(Entry & e);
+
+public:
+
+    // texture is the table slot and must outlive the cache; resident says
+    // whether it already holds the pixels
+    void add(TextureId id, sf::Texture & texture, Source source, bool resident);
+
+    // marks the texture used by the frame being recorded, loading it on a miss
+    void use(TextureId id)
+    {
+        if (id.index < m_entries.size() && m_entries[id.index].texture)
+        {
+            Entry & e = m_entries[id.index];
+            e.lastUsed = m_frame;
+            if (e.resident) { ++m_stats.hits; return; }
+            load(e);
+        }
+    }
+
+    // hint that the texture is needed soon; file sources decode on a worker
+    void prefetch(TextureId id);
+
+    // once per frame: applies finished prefetches, then evicts down to the budget
+    void update();
+
+    // evicts least recently used textures until under budget
+    void trim();
+
+    void         setBudget(std::size_t bytes) { m_budget = bytes; }
+    std::size_t  budget() const               { return m_budget; }
+    sf::Vector2u size(TextureId id) const;
+    bool         resident(TextureId id) const;
+    const Stats& stats() const                { return m_stats; }
+    void         resetStats();
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "EntityManager.h"
+#include "RenderQueue.h"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Static tiles baked into fixed-size chunks of grid cells.
+// Each chunk keeps one immutable StaticMesh per texture, which the renderer
+// uploads once into a static vertex buffer and redraws with one call; a chunk
+// is only re-baked after a tile in it is added, changed or removed.
+class TileLayer
+{
+    struct Tile
+    {
+        std::shared_ptr<Entity> entity;
+        const sf::Texture *     texture = nullptr;
+        TextureId               textureId;
+        sf::Vertex              quad[6];
+    };
+
+    struct Chunk
+    {
+        std::vector<Tile>                  tiles;
+        std::vector<std::shared_ptr<const StaticMesh>> meshes;
+        std::vector<TextureId>             textures;   // streamed textures the meshes draw from
+        sf::FloatRect                      bounds;
+        bool                               dirty = true;
+    };
+
+    sf::Vector2f                                       m_cellSize;
+    int                                                m_chunkCells;
+    std::unordered_map<std::uint64_t, Chunk>           m_chunks;
+    std::unordered_map<std::size_t, std::uint64_t>     m_tileChunk;   // entity id -> chunk
+    std::vector<TextureId>                             m_texturesDrawn;
+    std::size_t                                        m_chunksDrawn = 0;
+    std::size_t                                        m_rebakes     = 0;
+
+    static std::uint64_t key(int cx, int cy);
+    sf::Vector2i chunkOf(const sf::Vector2f & p) const;
+    void bake(Chunk & chunk);
+
+public:
+
+    explicit TileLayer(const sf::Vector2f & cellSize = {64.f, 64.f}, int chunkCells = 32);
+
+    // entities must have CTransform and a CAnimation playing a clip that never
+    // advances (clip is that clip); re-adding an entity updates its quad
+    static bool canBake(const Entity & e, const AnimationClip & clip);
+    void add(const std::shared_ptr<Entity> & e, const AnimationClip & clip);
+    void remove(const Entity & e);
+    void clear();
+
+    void draw(RenderQueue & queue, RenderLayer layer, const sf::FloatRect & area);
+
+    // streamed textures used by the last draw(); the caller keeps them resident
+    const std::vector<TextureId> & texturesDrawn() const;
+
+    // appends the live tile entities overlapping area (used by debug overlays)
+    void query(const sf::FloatRect & area, EntityVec & out) const;
+
+    std::size_t tileCount()   const;
+    std::size_t chunkCount()  const;
+    std::size_t chunksDrawn() const;
+    std::size_t rebakes()     const;
+    void        resetStats();
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "EntityManager.h"
+#include "ThreadPool.h"
+#include <SFML/Graphics/Rect.hpp>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Splits the world into fixed-size square chunks kept on disk, with only
+// those around the camera resident.
+//
+// The level is split into chunk files once, into a base directory next to
+// it that is reused while the level file is unchanged and only ever read.
+// Chunks a session changes go to its own working directory instead. Files
+// are read and written on one IO thread, in submission order, so a chunk
+// written on unload is never read back stale. The streamer only decides which chunks
+// come and go and moves their data; turning records into entities and back
+// is up to the scene. Resident chunks are bounded by the view, so memory and
+// per-frame work do not grow with the level.
+class WorldStreamer
+{
+public:
+
+    using Key = std::uint64_t;
+
+    // one serialized entity; strings are indices into ChunkData::names
+    struct Record
+    {
+        enum Flags : std::uint32_t
+        {
+            HAS_ANIMATION = 1u << 0,
+            REPEAT        = 1u << 1,
+            HAS_BBOX      = 1u << 2,
+            HAS_GRAVITY   = 1u << 3,
+            HAS_LIGHT     = 1u << 4,
+        };
+
+        std::uint32_t tag   = 0;
+        std::uint32_t anim  = 0;
+        std::uint32_t flags = 0;
+        std::uint32_t frame = 0;
+        float         elapsed = 0.f;
+        float         x = 0.f, y = 0.f, vx = 0.f, vy = 0.f, angle = 0.f, sx = 1.f, sy = 1.f;
+        float         bbw = 0.f, bbh = 0.f, bbox = 0.f, bboy = 0.f;
+        float         gx = 0.f, gy = 0.f;
+        float         lightRadius = 0.f, lightIntensity = 0.f;
+        std::uint8_t  lr = 0, lg = 0, lb = 0, la = 0;
+    };
+
+    struct ChunkData
+    {
+        std::vector<std::string> names;
+        std::vector<Record>      records;
+
+        std::uint32_t name(const std::string & s);   // adds s if new
+    };
+
+    struct Stats
+    {
+        std::size_t loads      = 0;
+        std::size_t unloads    = 0;
+        std::size_t migrations = 0;
+        std::size_t resident   = 0;
+        std::size_t loading    = 0;
+    };
+
+private:
+
+    enum class State { Loading, Resident };
+
+    struct Chunk
+    {
+        State                  state = State::Resident;
+        std::future<ChunkData> load;
+        EntityVec              entities;       // what the scene spawned for it
+    };
+
+    std::string                     m_dir;
+    std::string                     m_base;
+    std::string                     m_stamp;   // the source level and chunk size the base was split for
+    bool                            m_hasBase = false;
+    float                           m_chunkSize = 1024.f;
+    std::unordered_map<Key, Chunk>  m_chunks;  // loading or resident
+    std::unordered_set<Key>         m_stored;  // chunks with a file on disk, in either directory
+    std::unordered_set<Key>         m_written; // chunks this session rewrote into m_dir
+    std::unique_ptr<ThreadPool>     m_ownIo;   // unless begin was handed a shared one
+    ThreadPool *                    m_io = nullptr;
+    std::vector<std::future<void>>  m_writes;
+    Stats                           m_stats;
+
+    std::string file(const std::string & dir, Key key) const;
+    std::string readPath(Key key) const;       // the session's copy if any, else the base
+    void        submitWrite(Key key, ChunkData data, bool append);
+
+public:
+
+    WorldStreamer() = default;
+    ~WorldStreamer();
+
+    WorldStreamer(const WorldStreamer &) = delete;
+    WorldStreamer & operator=(const WorldStreamer &) = delete;
+
+    // Starts over with an empty working directory. base holds the level split
+    // into chunks; it counts only while its stamp matches source's size and
+    // mtime and the chunk size, otherwise hasBase() is false until writeBase.
+    // io: a single-threaded pool shared with other streamers, which must
+    // outlive this one; by default the streamer starts its own IO thread.
+    void begin(const std::string & dir, float chunkSize,
+               const std::string & base, const std::string & source, ThreadPool * io = nullptr);
+    // waits for pending IO and forgets every chunk
+    void end();
+    bool active() const { return m_io != nullptr; }
+    bool hasBase() const { return m_hasBase; }
+
+    Key           keyOf(float x, float y) const;
+    sf::FloatRect bounds(Key key) const;
+    float         chunkSize() const { return m_chunkSize; }
+
+    // replaces the base with these chunks, before streaming starts; the stamp
+    // goes last, so an interrupted write is redone next time
+    void writeBase(const std::unordered_map<Key, ChunkData> & chunks);
+
+    // Starts loading chunks that come within a chunk of view and returns the
+    // resident ones that are now more than two chunks away. The caller
+    // serializes and removes their entities, then hands them to store().
+    std::vector<Key> update(const sf::FloatRect & view);
+
+    // finished loads, now resident; the caller spawns them into entities(key)
+    std::vector<std::pair<Key, ChunkData>> takeLoaded();
+    // blocks until every load started so far has finished
+    void waitLoads();
+
+    bool       resident(Key key) const;
+    EntityVec& entities(Key key) { return m_chunks[key].entities; }
+
+    // unloads a resident chunk, writing data as its new contents
+    void store(Key key, ChunkData data);
+
+    // an entity that wandered into a chunk that is not in memory; false if
+    // that chunk is still loading and the entity has to stay for now
+    bool migrate(Key key, ChunkData data);
+
+    const Stats& stats() const { return m_stats; }
+};
@@ -0,0 +1,42 @@
+#include "../include/Action.h"
+
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    struct ActionNames {
+        std::vector<std::string>                  names{ "" };   // id 0 is "no action"
+        std::unordered_map<std::string, ActionId> ids;
+    };
+
+    ActionNames& actionNames() {
+        static ActionNames table;
+        return table;
+    }
+}
+
+ActionId Action::intern(const std::string& name) {
+    auto& t = actionNames();
+    if (auto it = t.ids.find(name); it != t.ids.end()) return it->second;
+    if (t.names.size() > std::numeric_limits<ActionId>::max()) {
+        std::cerr << "[Input] Too many actions, ignoring '" << name << "'\n";
+        return 0;
+    }
+    const auto id = static_cast<ActionId>(t.names.size());
+    t.names.push_back(name);
+    t.ids.emplace(name, id);
+    return id;
+}
+
+ActionId Action::find(const std::string& name) {
+    const auto& t = actionNames();
+    auto it = t.ids.find(name);
+    return it == t.ids.end() ? ActionId{0} : it->second;
+}
+
+const std::string& Action::nameOf(ActionId id) {
+    const auto& t = actionNames();
+    return id < t.names.size() ? t.names[id] : t.names[0];
+}
@@ -0,0 +1,188 @@
+#include "../include/AssetBundle.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr char        MAGIC[8] = { 'S', 'F', 'B', 'N', 'D', 'L', 0, 0 };
+    constexpr std::size_t ALIGN    = 16;
+
+    std::uint64_t aligned(std::uint64_t v) { return (v + ALIGN - 1) & ~std::uint64_t(ALIGN - 1); }
+}
+
+AssetBundle::~AssetBundle()
+{
+    close();
+}
+
+bool AssetBundle::open(const std::string & path)
+{
+    close();
+
+#ifdef _WIN32
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) { m_file = nullptr; std::cerr << "[Assets] Cannot open bundle: " << path << "\n"; return false; }
+    LARGE_INTEGER size;
+    GetFileSizeEx(m_file, &size);
+    m_size    = static_cast<std::size_t>(size.QuadPart);
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping) m_data = static_cast<const std::uint8_t *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    m_fd = ::open(path.c_str(), O_RDONLY);
+    if (m_fd < 0) { std::cerr << "[Assets] Cannot open bundle: " << path << "\n"; return false; }
+    struct stat st {};
+    if (fstat(m_fd, &st) == 0 && st.st_size > 0)
+    {
+        m_size = static_cast<std::size_t>(st.st_size);
+        void * p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (p != MAP_FAILED) m_data = static_cast<const std::uint8_t *>(p);
+    }
+#endif
+
+    if (!m_data)
+    {
+        std::cerr << "[Assets] Cannot map bundle: " << path << "\n";
+        close();
+        return false;
+    }
+
+    // validate the index once so accessors can trust it
+    const auto * h = reinterpret_cast<const Header *>(m_data);
+    const bool ok = m_size >= sizeof(Header)
+                 && std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) == 0
+                 && h->version == VERSION
+                 && sizeof(Header) + std::uint64_t(h->entryCount) * sizeof(Entry) <= m_size
+                 && h->stringsOffset + h->stringsSize <= m_size;
+    if (ok)
+    {
+        for (std::size_t i = 0; i < h->entryCount; ++i)
+        {
+            const Entry & e = entry(i);
+            if (e.offset + e.size > m_size || e.name >= h->stringsSize || e.path >= h->stringsSize)
+            {
+                std::cerr << "[Assets] Bundle entry " << i << " is out of range: " << path << "\n";
+                close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::cerr << "[Assets] Not a version " << VERSION << " bundle: " << path << "\n";
+    close();
+    return false;
+}
+
+void AssetBundle::close()
+{
+#ifdef _WIN32
+    if (m_data)    UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file)    CloseHandle(m_file);
+    m_mapping = m_file = nullptr;
+#else
+    if (m_data) munmap(const_cast<std::uint8_t *>(m_data), m_size);
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+std::size_t AssetBundle::entryCount() const
+{
+    return m_data ? reinterpret_cast<const Header *>(m_data)->entryCount : 0;
+}
+
+const AssetBundle::Entry & AssetBundle::entry(std::size_t i) const
+{
+    return reinterpret_cast<const Entry *>(m_data + sizeof(Header))[i];
+}
+
+std::string_view AssetBundle::string(std::uint32_t offset) const
+{
+    const auto * h = reinterpret_cast<const Header *>(m_data);
+    const char * s = reinterpret_cast<const char *>(m_data + h->stringsOffset + offset);
+    return std::string_view(s, strnlen(s, h->stringsSize - offset));
+}
+
+bool AssetBundle::isBundle(const std::string & path)
+{
+    std::ifstream fin(path, std::ios::binary);
+    char magic[sizeof(MAGIC)] = {};
+    return fin.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool AssetBundle::write(const std::string & path, const std::vector<Item> & items)
+{
+    // string table: offset 0 is the empty string
+    std::string strings(1, '\0');
+    const auto intern = [&](const std::string & s) -> std::uint32_t
+    {
+        if (s.empty()) return 0;
+        const auto at = static_cast<std::uint32_t>(strings.size());
+        strings += s;
+        strings += '\0';
+        return at;
+    };
+
+    std::vector<Entry> entries(items.size());
+    for (std::size_t i = 0; i < items.size(); ++i)
+    {
+        const Item & it = items[i];
+        entries[i] = { it.kind, intern(it.name), intern(it.path), it.a, it.b, it.c, 0, it.data.size() };
+    }
+
+    Header h{};
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version       = VERSION;
+    h.entryCount    = static_cast<std::uint32_t>(entries.size());
+    h.stringsOffset = sizeof(Header) + entries.size() * sizeof(Entry);
+    h.stringsSize   = strings.size();
+
+    std::uint64_t offset = aligned(h.stringsOffset + h.stringsSize);
+    for (auto & e : entries)
+    {
+        e.offset = offset;
+        offset   = aligned(offset + e.size);
+    }
+
+    std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+    if (!fout)
+    {
+        std::cerr << "[Assets] Cannot write bundle: " << path << "\n";
+        return false;
+    }
+
+    static const char zeros[ALIGN] = {};
+    std::uint64_t written = 0;
+    const auto put = [&](const void * p, std::size_t n)
+    {
+        fout.write(static_cast<const char *>(p), static_cast<std::streamsize>(n));
+        written += n;
+    };
+    const auto pad = [&](std::uint64_t to) { put(zeros, static_cast<std::size_t>(to - written)); };
+
+    put(&h, sizeof(h));
+    put(entries.data(), entries.size() * sizeof(Entry));
+    put(strings.data(), strings.size());
+    for (std::size_t i = 0; i < items.size(); ++i)
+    {
+        pad(entries[i].offset);
+        put(items[i].data.data(), items[i].data.size());
+    }
+    return static_cast<bool>(fout);
+}
@@ -2,6 +2,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 static bool isCommentOrBlank(const std::string& s) {
     for (char ch : s) {
@@ -12,12 +13,41 @@ static bool isCommentOrBlank(const std::string& s) {
 }
 
 void Assets::loadTexture(const std::string& name, const std::string& path, bool smooth) {
+    if (m_headless) {
+        sf::Image img;
+        if (!img.loadFromFile(path)) std::cerr << "[Assets] Failed texture: " << name << " <- " << path << "\n";
+        storeTexture(name, sf::Texture{}, { path, nullptr, img.getSize(), smooth });
+        return;
+    }
     sf::Texture t;
     if (!t.loadFromFile(path)) {
         std::cerr << "[Assets] Failed texture: " << name << " <- " << path << "\n";
     }
     t.setSmooth(smooth);
-    m_textures[name] = std::move(t);
+    storeTexture(name, std::move(t), { path, nullptr, {}, smooth });
+}
+
+TextureId Assets::storeTexture(const std::string& name, sf::Texture texture, TextureCache::Source source) {
+    // headless textures are never uploaded; the source says how big they would be
+    if (!m_headless) source.size = texture.getSize();
+    const TextureId id = m_textures.set(name, std::move(texture));
+    m_textureCache.add(id, m_textures.get(id), source, !m_headless);
+
+    auto& src  = m_textureSources[name];
+    src.name   = name;
+    src.path   = source.path;
+    src.pixels = source.pixels;
+    src.size   = source.size;
+    src.smooth = source.smooth;
+
+    // keeps loading within the budget: textures nothing has drawn yet go first
+    m_textureCache.trim();
+    return id;
+}
+
+void Assets::setTextureBudget(std::size_t bytes) {
+    m_textureCache.setBudget(bytes);
+    m_textureCache.trim();
 }
 
 void Assets::loadFont(const std::string& name, const std::string& path) {
@@ -25,7 +55,7 @@ void Assets::loadFont(const std::string& name, const std::string& path) {
     if (!f.openFromFile(path)) {
         std::cerr << "[Assets] Failed font: " << name << " <- " << path << "\n";
     }
-    m_fonts[name] = std::move(f);
+    m_fonts.set(name, std::move(f));
 }
 
 void Assets::loadSound(const std::string& name, const std::string& path) {
@@ -33,7 +63,7 @@ void Assets::loadSound(const std::string& name, const std::string& path) {
     if (!b.loadFromFile(path)) {
         std::cerr << "[Assets] Failed sound: " << name << " <- " << path << "\n";
     }
-    m_sounds[name] = std::move(b);
+    m_sounds.set(name, std::move(b));
 }
 
 // Simple config loader.
@@ -41,13 +71,23 @@ void Assets::loadSound(const std::string& name, const std::string& path) {
 //   Texture   Name path/to/tex.png
 //   Font      Name path/to/font.ttf
 //   Sound     Name path/to/sound.wav
-//   Animation Name TextureName frameCount speed
+//   Animation Name TextureName frameCount speed        (horizontal strip, speed in frames at 60Hz)
+//   Clip      Name TextureName frameW frameH cols rows start end fps [margin spacing]
+//   AtlasFrames TextureName frameW frameH cols rows start end [margin spacing]
+//   Atlas     pageSize [cacheDir]
+//   TextureBudget megabytes                            (0 = keep every texture resident)
+//   Prefabs   path/to/archetypes.txt                   (entity prefabs, loaded by the engine)
 void Assets::loadFromFile(const std::string& path) {
+    if (beginLoad(path)) finishLoad();
+}
+
+bool Assets::beginLoad(const std::string& path) {
     std::ifstream fin(path);
     if (!fin) {
         std::cerr << "[Assets] Cannot open config: " << path << "\n";
-        return;
+        return false;
     }
+    if (!m_loader) m_loader = std::make_unique<ThreadPool>();
 
     std::string line;
     size_t ln = 0;
@@ -60,79 +100,366 @@ void Assets::loadFromFile(const std::string& path) {
         std::string kind;
         iss >> kind;
 
-        if (kind == "Texture") {
-            std::string name, file;
-            iss >> name >> file;
-            if (name.empty() || file.empty()) {
-                std::cerr << "[Assets] Bad Texture line " << ln << "\n";
-                continue;
-            }
-            loadTexture(name, file, true);
-        } else if (kind == "Font") {
-            std::string name, file;
-            iss >> name >> file;
-            if (name.empty() || file.empty()) {
-                std::cerr << "[Assets] Bad Font line " << ln << "\n";
-                continue;
-            }
-            loadFont(name, file);
-        } else if (kind == "Sound") {
-            std::string name, file;
-            iss >> name >> file;
-            if (name.empty() || file.empty()) {
-                std::cerr << "[Assets] Bad Sound line " << ln << "\n";
+        if (kind == "Font" || kind == "Prefabs") {
+            applyLine(line, ln);
+            continue;
+        }
+
+        Pending p;
+        p.line = line;
+        p.ln   = ln;
+        if (kind == "Atlas") {
+            // packing needs every texture above it, so the job starts in pump
+            p.atlasPage = 2048;
+            iss >> p.atlasPage >> p.path;
+        } else if (kind == "Texture" || kind == "Sound") {
+            iss >> p.name >> p.path;
+            if (p.name.empty() || p.path.empty()) {
+                std::cerr << "[Assets] Bad " << kind << " line " << ln << "\n";
                 continue;
             }
-            loadSound(name, file);
-        } else if (kind == "Animation") {
-            std::string name, texName;
-            std::size_t frameCount = 1, speed = 0;
-            iss >> name >> texName >> frameCount >> speed;
-            if (name.empty() || texName.empty()) {
-                std::cerr << "[Assets] Bad Animation line " << ln << "\n";
-                continue;
+            // decoding is CPU only; the texture upload waits for the owning thread
+            if (kind == "Texture") {
+                p.image = m_loader->submit([file = p.path]() -> std::optional<sf::Image> {
+                    sf::Image img;
+                    if (!img.loadFromFile(file)) return std::nullopt;
+                    return img;
+                });
+            } else {
+                p.sound = m_loader->submit([file = p.path]() -> std::optional<sf::SoundBuffer> {
+                    sf::SoundBuffer b;
+                    if (!b.loadFromFile(file)) return std::nullopt;
+                    return b;
+                });
             }
-            auto it = m_textures.find(texName);
-            if (it == m_textures.end()) {
-                std::cerr << "[Assets] Animation texture missing: " << texName
-                          << " (line " << ln << ")\n";
-                continue;
+        }
+        m_pending.push_back(std::move(p));
+        ++m_loadTotal;
+    }
+    return true;
+}
+
+bool Assets::loadBundle(const std::string& path) {
+    if (m_bundle.isOpen()) {
+        std::cerr << "[Assets] A bundle is already loaded, ignoring " << path << "\n";
+        return false;
+    }
+    if (!m_bundle.open(path)) return false;
+
+    using Kind = AssetBundle::Kind;
+    std::string_view config;
+    for (std::size_t i = 0; i < m_bundle.entryCount(); ++i) {
+        const auto& e = m_bundle.entry(i);
+        const std::string name(m_bundle.string(e.name));
+        const std::uint8_t* data = m_bundle.data(e);
+
+        if (e.kind == Kind::Texture && m_headless) {
+            storeTexture(name, sf::Texture{}, { std::string(m_bundle.string(e.path)), data, {e.a, e.b}, e.c != 0 });
+        } else if (e.kind == Kind::Texture) {
+            sf::Texture t;
+            const bool ok = e.size >= std::uint64_t(e.a) * e.b * 4 && t.resize({e.a, e.b});
+            if (!ok) {
+                std::cerr << "[Assets] Failed bundled texture: " << name << "\n";
+            } else {
+                t.update(data);
             }
-            addAnimation(name, Animation(name, it->second, frameCount, speed));
-        } else {
-            std::cerr << "[Assets] Unknown kind '" << kind << "' on line " << ln << "\n";
+            t.setSmooth(e.c != 0);
+            // reloads after eviction come straight from the mapping again
+            storeTexture(name, std::move(t), { std::string(m_bundle.string(e.path)), ok ? data : nullptr, {}, e.c != 0 });
+        } else if (e.kind == Kind::Font) {
+            sf::Font f;
+            if (!f.openFromMemory(data, e.size))
+                std::cerr << "[Assets] Failed bundled font: " << name << "\n";
+            m_fonts.set(name, std::move(f));
+        } else if (e.kind == Kind::Sound) {
+            std::vector<sf::SoundChannel> channels;
+            for (std::uint32_t c = 0; c < e.a && c < e.c; ++c)
+                channels.push_back(static_cast<sf::SoundChannel>(data[c]));
+            sf::SoundBuffer b;
+            const auto* samples = reinterpret_cast<const std::int16_t*>(data + e.c);
+            if (!b.loadFromSamples(samples, (e.size - e.c) / sizeof(std::int16_t), e.a, e.b, channels))
+                std::cerr << "[Assets] Failed bundled sound: " << name << "\n";
+            m_sounds.set(name, std::move(b));
+        } else if (e.kind == Kind::Config) {
+            config = std::string_view(reinterpret_cast<const char*>(data), e.size);
         }
     }
+
+    // animations, atlas and friends refer to the assets above, so they go last
+    std::size_t ln = 0;
+    while (!config.empty()) {
+        const auto nl = config.find('\n');
+        const std::string line(config.substr(0, nl));
+        config.remove_prefix(nl == std::string_view::npos ? config.size() : nl + 1);
+        ++ln;
+        if (!isCommentOrBlank(line)) applyLine(line, ln);
+    }
+    return true;
 }
 
-const sf::Texture& Assets::getTexture(const std::string& n) const {
-    static sf::Texture dummy;
-    auto it = m_textures.find(n);
-    if (it == m_textures.end()) { std::cerr << "[Assets] Missing texture: " << n << "\n"; return dummy; }
-    return it->second;
+bool Assets::updateLoad(std::chrono::microseconds budget) {
+    return pump(false, budget);
 }
 
-const sf::Font& Assets::getFont(const std::string& n) const {
-    static sf::Font dummy;
-    auto it = m_fonts.find(n);
-    if (it == m_fonts.end()) { std::cerr << "[Assets] Missing font: " << n << "\n"; return dummy; }
-    return it->second;
+void Assets::finishLoad() {
+    pump(true, std::chrono::microseconds::max());
 }
 
-const sf::SoundBuffer& Assets::getSound(const std::string& n) const {
-    static sf::SoundBuffer dummy;
-    auto it = m_sounds.find(n);
-    if (it == m_sounds.end()) { std::cerr << "[Assets] Missing sound: " << n << "\n"; return dummy; }
-    return it->second;
+bool Assets::pump(bool block, std::chrono::microseconds budget) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto ready = [](const auto& f) {
+        return !f.valid() || f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+
+    // strictly in config order, so Animation/Atlas lines see the textures before them
+    while (!m_pending.empty()) {
+        Pending& p = m_pending.front();
+        if (p.atlasPage && !p.atlas.valid() && !m_headless && m_atlas.pageCount() == 0) {
+            p.atlas = m_loader->submit([sources = atlasSources(), size = TextureAtlas::pageSizeFor(p.atlasPage),
+                                        dir = p.path] { return TextureAtlas::pack(sources, size, dir); });
+        }
+        if (!block && (!ready(p.image) || !ready(p.sound) || !ready(p.atlas))) break;
+        apply(p);
+        m_pending.pop_front();
+        ++m_loadDone;
+        if (!block && std::chrono::steady_clock::now() - start >= budget) break;
+    }
+
+    if (m_pending.empty()) m_loader.reset();
+    return m_pending.empty();
 }
 
-const Animation& Assets::getAnimation(const std::string& n) const {
-    static Animation dummy;
-    auto it = m_anims.find(n);
-    if (it == m_anims.end()) { std::cerr << "[Assets] Missing animation: " << n << "\n"; return dummy; }
-    return it->second;
+void Assets::apply(Pending& p) {
+    if (p.image.valid() && m_headless) {
+        auto img = p.image.get();
+        if (!img) std::cerr << "[Assets] Failed texture: " << p.name << " <- " << p.path << "\n";
+        storeTexture(p.name, sf::Texture{}, { p.path, nullptr, img ? img->getSize() : sf::Vector2u{}, true });
+    } else if (p.image.valid()) {
+        auto img = p.image.get();
+        sf::Texture t;
+        if (!img || !t.loadFromImage(*img)) {
+            std::cerr << "[Assets] Failed texture: " << p.name << " <- " << p.path << "\n";
+        }
+        t.setSmooth(true);
+        storeTexture(p.name, std::move(t), { p.path, nullptr, {}, true });
+    } else if (p.sound.valid()) {
+        auto b = p.sound.get();
+        if (!b) std::cerr << "[Assets] Failed sound: " << p.name << " <- " << p.path << "\n";
+        m_sounds.set(p.name, b ? std::move(*b) : sf::SoundBuffer{});
+    } else if (p.atlas.valid()) {
+        useAtlas(p.atlas.get());
+    } else {
+        applyLine(p.line, p.ln);
+    }
 }
 
+void Assets::applyLine(const std::string& line, std::size_t ln) {
+    std::istringstream iss(line);
+    std::string kind;
+    iss >> kind;
+
+    if (kind == "Texture") {
+        std::string name, file;
+        iss >> name >> file;
+        if (name.empty() || file.empty()) {
+            std::cerr << "[Assets] Bad Texture line " << ln << "\n";
+            return;
+        }
+        loadTexture(name, file, true);
+    } else if (kind == "Font") {
+        std::string name, file;
+        iss >> name >> file;
+        if (name.empty() || file.empty()) {
+            std::cerr << "[Assets] Bad Font line " << ln << "\n";
+            return;
+        }
+        loadFont(name, file);
+    } else if (kind == "Sound") {
+        std::string name, file;
+        iss >> name >> file;
+        if (name.empty() || file.empty()) {
+            std::cerr << "[Assets] Bad Sound line " << ln << "\n";
+            return;
+        }
+        loadSound(name, file);
+    } else if (kind == "Animation") {
+        std::string name, texName;
+        std::size_t frameCount = 1, speed = 0;
+        iss >> name >> texName >> frameCount >> speed;
+        if (name.empty() || texName.empty()) {
+            std::cerr << "[Assets] Bad Animation line " << ln << "\n";
+            return;
+        }
+        const TextureId tex = m_textures.find(texName);
+        if (!tex) {
+            std::cerr << "[Assets] Animation texture missing: " << texName
+                      << " (line " << ln << ")\n";
+            return;
+        }
+        if (frameCount == 0) frameCount = 1;
+        // the recorded size: the texture itself may already be evicted
+        const int w = static_cast<int>(m_textureCache.size(tex).x / frameCount);
+        const int h = static_cast<int>(m_textureCache.size(tex).y);
+        const auto frames = makeGridFrames(w, h, static_cast<int>(frameCount), 1,
+                                           0, static_cast<int>(frameCount) - 1);
+        addAnimation(AnimationClip(name, texName, getTexture(tex), frames, static_cast<float>(speed) / 60.f));
+    } else if (kind == "Clip") {
+        std::string name, texName;
+        int w = 0, h = 0, cols = 0, rows = 0, start = 0, end = -1, margin = 0, spacing = 0;
+        float fps = 0.f;
+        iss >> name >> texName >> w >> h >> cols >> rows >> start >> end >> fps;
+        if (name.empty() || w <= 0 || h <= 0 || end < start) {
+            std::cerr << "[Assets] Bad Clip line " << ln << "\n";
+            return;
+        }
+        iss >> margin >> spacing;
+        const TextureId tex = m_textures.find(texName);
+        if (!tex) {
+            std::cerr << "[Assets] Clip texture missing: " << texName
+                      << " (line " << ln << ")\n";
+            return;
+        }
+        addAnimation(AnimationClip(name, texName, getTexture(tex),
+                                   makeGridFrames(w, h, cols, rows, start, end, margin, spacing),
+                                   fps > 0.f ? 1.f / fps : 0.f));
+    } else if (kind == "AtlasFrames") {
+        std::string texName;
+        int w = 0, h = 0, cols = 0, rows = 0, start = 0, end = -1, margin = 0, spacing = 0;
+        iss >> texName >> w >> h >> cols >> rows >> start >> end;
+        if (texName.empty() || w <= 0 || h <= 0 || end < start) {
+            std::cerr << "[Assets] Bad AtlasFrames line " << ln << "\n";
+            return;
+        }
+        iss >> margin >> spacing;
+        addAtlasFrames(texName, makeGridFrames(w, h, cols, rows, start, end, margin, spacing));
+    } else if (kind == "TextureBudget") {
+        std::size_t megabytes = 0;
+        iss >> megabytes;
+        setTextureBudget(megabytes * 1024 * 1024);
+    } else if (kind == "Prefabs") {
+        iss >> m_prefabsPath;
+        if (m_prefabsPath.empty()) std::cerr << "[Assets] Bad Prefabs line " << ln << "\n";
+    } else if (kind == "Atlas") {
+        unsigned pageSize = 2048;
+        std::string cacheDir;
+        iss >> pageSize >> cacheDir;
+        if (!m_headless) buildAtlas(pageSize, cacheDir);
+    } else {
+        std::cerr << "[Assets] Unknown kind '" << kind << "' on line " << ln << "\n";
+    }
+}
+
+TextureId Assets::getTextureId(const std::string& n) const {
+    const TextureId id = m_textures.find(n);
+    if (!id) std::cerr << "[Assets] Missing texture: " << n << "\n";
+    return id;
+}
+
+FontId Assets::getFontId(const std::string& n) const {
+    const FontId id = m_fonts.find(n);
+    if (!id) std::cerr << "[Assets] Missing font: " << n << "\n";
+    return id;
+}
+
+SoundId Assets::getSoundId(const std::string& n) const {
+    const SoundId id = m_sounds.find(n);
+    if (!id) std::cerr << "[Assets] Missing sound: " << n << "\n";
+    return id;
+}
+
+AnimId Assets::getAnimationId(const std::string& n) const {
+    const AnimId id = m_anims.find(n);
+    if (!id) std::cerr << "[Assets] Missing animation: " << n << "\n";
+    return id;
+}
+
+AnimId Assets::findAnimationId(const std::string& n) const {
+    return m_anims.find(n);
+}
+
+AnimId Assets::addAnimation(const AnimationClip& clip) {
+    const AnimId id = m_anims.set(clip.name, clip);
+    m_anims.get(id).textureId = m_textures.find(clip.source);
+    mapToAtlas(m_anims.get(id));
+    return id;
+}
+
+AnimId Assets::frameClip(AnimId clip, const sf::IntRect& rect) {
+    const FrameKey key{ clip.index, rect.position.x, rect.position.y, rect.size.x, rect.size.y };
+    if (auto it = m_frameClips.find(key); it != m_frameClips.end()) return it->second;
+
+    // built from the source texture; addAnimation moves it onto the atlas if the rect was packed
+    const AnimationClip& base = getAnimation(clip);
+    const TextureId src = m_textures.find(base.source);
+    if (!src) return clip;
+    const std::string name = base.name + "@" + std::to_string(rect.position.x) + "," + std::to_string(rect.position.y)
+                           + "," + std::to_string(rect.size.x) + "x" + std::to_string(rect.size.y);
+    const AnimId id = addAnimation(AnimationClip(name, base.source, getTexture(src), { rect }, 0.f));
+    m_frameClips.emplace(key, id);
+    return id;
+}
+
+void Assets::mapToAtlas(AnimationClip& clip) const {
+    if (!m_atlas.contains(clip.source)) return;
+
+    std::vector<sf::IntRect> frames;
+    const sf::Texture* page = nullptr;
+    for (const auto& f : clip.frames) {
+        auto m = m_atlas.map(clip.source, f);
+        if (!m || (page && page != m->texture)) return;
+        page = m->texture;
+        frames.push_back(m->rect);
+    }
+    // atlas pages stay resident, so the clip no longer streams its source
+    clip.texture   = page;
+    clip.textureId = {};
+    clip.frames    = std::move(frames);
+}
+
+void Assets::addAtlasFrames(const std::string& texture, const std::vector<sf::IntRect>& frames) {
+    auto it = m_textureSources.find(texture);
+    if (it == m_textureSources.end()) {
+        std::cerr << "[Assets] Atlas frames for unknown texture: " << texture << "\n";
+        return;
+    }
+    // a reloaded config repeats its AtlasFrames lines; pack each rect once
+    auto& rects = it->second.rects;
+    for (const auto& f : frames)
+        if (std::find(rects.begin(), rects.end(), f) == rects.end()) rects.push_back(f);
+}
+
+std::vector<TextureAtlas::Source> Assets::atlasSources() const {
+    // fonts are left alone: sf::Font owns and grows its own glyph pages
+    std::vector<TextureAtlas::Source> sources;
+    sources.reserve(m_textureSources.size());
+    for (const auto& [name, src] : m_textureSources) sources.push_back(src);
+    std::sort(sources.begin(), sources.end(),
+              [](const auto& a, const auto& b) { return a.name < b.name; });
+    return sources;
+}
+
+bool Assets::buildAtlas(unsigned pageSize, const std::string& cacheDir) {
+    // clips already point into the current pages, so a second pack would leave them dangling
+    if (m_atlas.pageCount() != 0) {
+        std::cerr << "[Assets] Atlas already built, ignoring rebuild\n";
+        return false;
+    }
+    return useAtlas(TextureAtlas::pack(atlasSources(), TextureAtlas::pageSizeFor(pageSize), cacheDir));
+}
+
+bool Assets::useAtlas(TextureAtlas::Packed packed) {
+    if (!m_atlas.upload(std::move(packed))) return false;
+
+    // clips keep their source-sheet rects in frames until mapped, so map from the source
+    for (auto& clip : m_anims) {
+        if (!m_atlas.contains(clip.source)) continue;
+        const sf::Texture* before = clip.texture;
+        mapToAtlas(clip);
+        if (clip.texture == before)
+            std::cerr << "[Assets] Animation '" << clip.name << "' has frames outside the atlas, left unpacked\n";
+    }
+    return true;
+}
 
 std::vector<sf::IntRect> Assets::makeGridFrames(int w,int h,int cols,int rows,
                                                 int start,int end,int margin,int spacing) const {
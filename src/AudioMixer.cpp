@@ -0,0 +1,250 @@
+#include "../include/AudioMixer.h"
+#include "../include/Assets.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // below this a voice is not worth starting
+    constexpr float AUDIBLE = 0.001f;
+
+    const sf::SoundBuffer & silence()
+    {
+        static const sf::SoundBuffer buffer;
+        return buffer;
+    }
+}
+
+SfmlAudioDevice::SfmlAudioDevice(std::size_t voices)
+{
+    m_sounds.reserve(voices);
+    for (std::size_t i = 0; i < voices; ++i)
+    {
+        // the mixer pans and attenuates itself
+        auto & s = m_sounds.emplace_back(silence());
+        s.setSpatializationEnabled(false);
+    }
+}
+
+void SfmlAudioDevice::start(std::size_t voice, const sf::SoundBuffer & buffer,
+                            float volume, float pan, float pitch, bool loop)
+{
+    sf::Sound & s = m_sounds[voice];
+    s.stop();
+    s.setBuffer(buffer);
+    s.setVolume(volume * 100.f);
+    s.setPan(pan);
+    s.setPitch(pitch);
+    s.setLooping(loop);
+    s.play();
+}
+
+void SfmlAudioDevice::set(std::size_t voice, float volume, float pan)
+{
+    m_sounds[voice].setVolume(volume * 100.f);
+    m_sounds[voice].setPan(pan);
+}
+
+void SfmlAudioDevice::stop(std::size_t voice)
+{
+    m_sounds[voice].stop();
+}
+
+bool SfmlAudioDevice::playing(std::size_t voice) const
+{
+    return m_sounds[voice].getStatus() == sf::SoundSource::Status::Playing;
+}
+
+void NullAudioDevice::start(std::size_t voice, const sf::SoundBuffer & buffer,
+                            float volume, float pan, float pitch, bool loop)
+{
+    const float seconds = buffer.getDuration().asSeconds() / std::max(pitch, 0.01f);
+    m_voices[voice] = { loop ? -1.f : seconds, volume, pan };
+}
+
+void NullAudioDevice::set(std::size_t voice, float volume, float pan)
+{
+    m_voices[voice].volume = volume;
+    m_voices[voice].pan    = pan;
+}
+
+void NullAudioDevice::stop(std::size_t voice)
+{
+    m_voices[voice].remaining = 0.f;
+}
+
+bool NullAudioDevice::playing(std::size_t voice) const
+{
+    return m_voices[voice].remaining != 0.f;
+}
+
+void NullAudioDevice::update(float dt)
+{
+    for (auto & v : m_voices)
+        if (v.remaining > 0.f) v.remaining = std::max(0.f, v.remaining - dt);
+}
+
+AudioMixer::AudioMixer(const Assets & assets, std::unique_ptr<AudioDevice> device)
+: m_assets(assets)
+, m_device(device ? std::move(device) : std::make_unique<NullAudioDevice>())
+, m_voices(m_device->voiceCount())
+{
+}
+
+AudioMixer::~AudioMixer()
+{
+    stopAll();
+}
+
+void AudioMixer::define(SoundId id, const SoundParams & params)
+{
+    if (!id) return;
+    if (id.index >= m_params.size()) m_params.resize(id.index + 1, m_defaults);
+    m_params[id.index] = params;
+}
+
+const AudioMixer::SoundParams & AudioMixer::params(SoundId id) const
+{
+    return id.index < m_params.size() ? m_params[id.index] : m_defaults;
+}
+
+float AudioMixer::attenuation(const SoundParams & p, const sf::Vector2f & pos, float & pan) const
+{
+    const sf::Vector2f d = pos - m_listener;
+    const float dist = std::sqrt(d.x * d.x + d.y * d.y);
+    pan = p.maxDistance > 0.f ? std::clamp(d.x / p.maxDistance, -1.f, 1.f) : 0.f;
+
+    if (dist <= p.minDistance) return 1.f;
+    if (dist >= p.maxDistance) return 0.f;
+    return 1.f - (dist - p.minDistance) / (p.maxDistance - p.minDistance);
+}
+
+AudioMixer::VoiceId AudioMixer::play(SoundId id, float volume)
+{
+    return start(id, volume, false, {});
+}
+
+AudioMixer::VoiceId AudioMixer::playAt(SoundId id, const sf::Vector2f & position, float volume)
+{
+    return start(id, volume, true, position);
+}
+
+AudioMixer::VoiceId AudioMixer::start(SoundId id, float volume, bool positional, const sf::Vector2f & pos)
+{
+    if (!id || m_voices.empty()) return {};
+
+    const SoundParams & p = params(id);
+    float pan = 0.f;
+    const float base = volume * p.volume;
+    const float gain = base * (positional ? attenuation(p, pos, pan) : 1.f);
+    if (gain < AUDIBLE)
+    {
+        ++m_stats.culled;
+        return {};
+    }
+
+    // one pass: free voice, this sound's oldest instance, and the least important voice
+    std::size_t free = m_voices.size(), oldestSame = free, weakest = free;
+    unsigned instances = 0;
+    for (std::size_t i = 0; i < m_voices.size(); ++i)
+    {
+        const Voice & v = m_voices[i];
+        if (!v.active)
+        {
+            if (free == m_voices.size()) free = i;
+            continue;
+        }
+        if (v.sound == id)
+        {
+            ++instances;
+            if (oldestSame == m_voices.size() || v.started < m_voices[oldestSame].started) oldestSame = i;
+        }
+        if (weakest == m_voices.size()) { weakest = i; continue; }
+        const Voice & w = m_voices[weakest];
+        if (v.priority != w.priority ? v.priority < w.priority
+          : v.gain != w.gain         ? v.gain < w.gain
+          :                            v.started < w.started)
+            weakest = i;
+    }
+
+    std::size_t slot = free;
+    if (p.maxInstances > 0 && instances >= p.maxInstances)
+    {
+        slot = oldestSame;
+        ++m_stats.limited;
+    }
+    else if (slot == m_voices.size())
+    {
+        // only steal from voices that matter less than this one
+        const Voice & w = m_voices[weakest];
+        if (w.priority > p.priority || (w.priority == p.priority && w.gain > gain))
+        {
+            ++m_stats.culled;
+            return {};
+        }
+        slot = weakest;
+        ++m_stats.stolen;
+    }
+
+    Voice & v = m_voices[slot];
+    if (v.active) m_device->stop(slot);
+    v.sound      = id;
+    v.volume     = base;
+    v.gain       = gain;
+    v.priority   = p.priority;
+    v.positional = positional;
+    v.position   = pos;
+    v.active     = true;
+    v.started    = ++m_sequence;
+    if (++v.generation == 0) v.generation = 1;
+
+    m_device->start(slot, m_assets.getSound(id), gain, pan, p.pitch, p.loop);
+    ++m_stats.played;
+    return { static_cast<std::uint32_t>(slot), v.generation };
+}
+
+void AudioMixer::stop(VoiceId voice)
+{
+    if (!voice || voice.index >= m_voices.size()) return;
+    Voice & v = m_voices[voice.index];
+    if (!v.active || v.generation != voice.generation) return;
+    m_device->stop(voice.index);
+    v.active = false;
+}
+
+void AudioMixer::stopAll()
+{
+    for (std::size_t i = 0; i < m_voices.size(); ++i)
+    {
+        if (!m_voices[i].active) continue;
+        m_device->stop(i);
+        m_voices[i].active = false;
+    }
+}
+
+void AudioMixer::update(float dt)
+{
+    m_device->update(dt);
+    for (std::size_t i = 0; i < m_voices.size(); ++i)
+    {
+        Voice & v = m_voices[i];
+        if (!v.active) continue;
+        if (!m_device->playing(i))
+        {
+            v.active = false;
+            continue;
+        }
+        if (!v.positional) continue;
+
+        // the listener follows the camera, so positional voices re-attenuate every frame
+        float pan = 0.f;
+        v.gain = v.volume * attenuation(params(v.sound), v.position, pan);
+        m_device->set(i, v.gain, pan);
+    }
+}
+
+std::size_t AudioMixer::activeVoices() const
+{
+    return static_cast<std::size_t>(std::count_if(m_voices.begin(), m_voices.end(),
+                                                  [](const Voice & v) { return v.active; }));
+}
@@ -0,0 +1,124 @@
+#include "../include/DebugDraw.h"
+#include <cmath>
+
+DebugDraw::TextBatch & DebugDraw::batchFor(const sf::Font & font, unsigned size)
+{
+    for (auto & b : m_text)
+        if (b.font == &font && b.size == size) return b;
+
+    // same quad layout as sf::Text, with its 1px glyph padding
+    TextBatch batch;
+    batch.font = &font;
+    batch.size = size;
+    const float padding = 1.f;
+    std::lock_guard<std::mutex> lock(glyphMutex());
+    for (char c = FIRST_GLYPH; c <= LAST_GLYPH; ++c)
+    {
+        const sf::Glyph & g = font.getGlyph(static_cast<char32_t>(c), size, false);
+        auto & q = batch.glyphs[c - FIRST_GLYPH];
+        q.advance = g.advance;
+        q.bounds  = { g.bounds.position - sf::Vector2f{padding, padding},
+                      g.bounds.size + sf::Vector2f{2.f * padding, 2.f * padding} };
+        q.texRect = { sf::Vector2f(g.textureRect.position) - sf::Vector2f{padding, padding},
+                      sf::Vector2f(g.textureRect.size) + sf::Vector2f{2.f * padding, 2.f * padding} };
+    }
+    batch.texture = &font.getTexture(size);
+    m_text.push_back(std::move(batch));
+    return m_text.back();
+}
+
+void DebugDraw::line(const Vec2 & a, const Vec2 & b, const sf::Color & color)
+{
+    m_lines.push_back({ {a.x, a.y}, color });
+    m_lines.push_back({ {b.x, b.y}, color });
+}
+
+void DebugDraw::rect(const Vec2 & p, const Vec2 & size, const sf::Color & color)
+{
+    const Vec2 q = p + size;
+    line({p.x, p.y}, {q.x, p.y}, color);
+    line({q.x, p.y}, {q.x, q.y}, color);
+    line({q.x, q.y}, {p.x, q.y}, color);
+    line({p.x, q.y}, {p.x, p.y}, color);
+}
+
+void DebugDraw::fillRect(const Vec2 & p, const Vec2 & size, const sf::Color & color)
+{
+    const sf::Vector2f a{p.x, p.y}, b{p.x + size.x, p.y}, c{p.x, p.y + size.y}, d{p.x + size.x, p.y + size.y};
+    m_triangles.insert(m_triangles.end(), { {a, color}, {b, color}, {c, color},
+                                            {c, color}, {b, color}, {d, color} });
+}
+
+void DebugDraw::circle(const Vec2 & center, float radius, const sf::Color & color, int points)
+{
+    if (points < 3) points = 3;
+    const float step = 2.f * 3.14159265f / static_cast<float>(points);
+    Vec2 prev{center.x + radius, center.y};
+    for (int i = 1; i <= points; ++i)
+    {
+        const float a = step * static_cast<float>(i);
+        const Vec2 next{center.x + radius * std::cos(a), center.y + radius * std::sin(a)};
+        line(prev, next, color);
+        prev = next;
+    }
+}
+
+void DebugDraw::text(const sf::Font & font, unsigned size, const Vec2 & pos, std::string_view str,
+                     const sf::Color & color)
+{
+    auto & batch = batchFor(font, size);
+
+    // sf::Text puts the first baseline one character size below the top
+    float x = pos.x;
+    const float y = pos.y + static_cast<float>(size);
+
+    for (char c : str)
+    {
+        if (c < FIRST_GLYPH || c > LAST_GLYPH) continue;
+        const auto & g = batch.glyphs[c - FIRST_GLYPH];
+
+        const float l = x + g.bounds.position.x;
+        const float t = y + g.bounds.position.y;
+        const float r = l + g.bounds.size.x;
+        const float b = t + g.bounds.size.y;
+        const float u0 = g.texRect.position.x, v0 = g.texRect.position.y;
+        const float u1 = u0 + g.texRect.size.x, v1 = v0 + g.texRect.size.y;
+
+        batch.vertices.insert(batch.vertices.end(), {
+            { {l, t}, color, {u0, v0} }, { {r, t}, color, {u1, v0} }, { {l, b}, color, {u0, v1} },
+            { {l, b}, color, {u0, v1} }, { {r, t}, color, {u1, v0} }, { {r, b}, color, {u1, v1} } });
+
+        x += g.advance;
+    }
+}
+
+void DebugDraw::flush(RenderFrame & frame)
+{
+    if (!m_triangles.empty())
+    {
+        frame.draw(m_triangles.data(), m_triangles.size(), sf::PrimitiveType::Triangles);
+        ++m_drawCalls;
+    }
+    if (!m_lines.empty())
+    {
+        frame.draw(m_lines.data(), m_lines.size(), sf::PrimitiveType::Lines);
+        ++m_drawCalls;
+    }
+    for (auto & b : m_text)
+    {
+        if (b.vertices.empty()) continue;
+        frame.draw(b.vertices.data(), b.vertices.size(), sf::PrimitiveType::Triangles, b.texture);
+        ++m_drawCalls;
+    }
+    clear();
+}
+
+void DebugDraw::clear()
+{
+    m_lines.clear();
+    m_triangles.clear();
+    for (auto & b : m_text) b.vertices.clear();
+}
+
+std::size_t DebugDraw::drawCalls() const { return m_drawCalls; }
+void        DebugDraw::resetStats()      { m_drawCalls = 0; }
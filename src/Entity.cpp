@@ -6,6 +6,13 @@ Entity::Entity(std::size_t id, const std::string& tag)
 , m_components{}
 {}
 
+Entity::Entity(std::size_t id, const std::string& tag, const ComponentTuple& components)
+: m_id(id)
+, m_tag(tag)
+, m_components(components)
+{}
+
+size_t Entity::id() const { return m_id; }
 bool Entity::isActive() const { return m_active; }
 const std::string& Entity::tag() const { return m_tag; }
 void Entity::destroy() { m_active = false; }
@@ -1,4 +1,5 @@
 #include "../include/EntityManager.h"
+#include <algorithm>
 
 EntityManager::EntityManager() {}
 
@@ -6,11 +7,21 @@ void EntityManager::update()
 {
     for (auto &e : m_entitiesToAdd)
         m_entities.push_back(e), m_entityMap[e->tag()].push_back(e);
+    m_entitiesAdded.swap(m_entitiesToAdd);
     m_entitiesToAdd.clear();
 
     for (auto & [tag, vec] : m_entityMap)
         removeDeadEntities(vec);
-    removeDeadEntities(m_entities);
+
+    // the main list also hands its dead over once, for anything else still holding them
+    m_entitiesRemoved.clear();
+    auto live = m_entities.begin();
+    for (auto & e : m_entities) {
+        if (!e->isActive())  m_entitiesRemoved.push_back(std::move(e));
+        else if (&*live != &e) *live++ = std::move(e);
+        else                 ++live;
+    }
+    m_entities.erase(live, m_entities.end());
 }
 
 void EntityManager::removeDeadEntities(EntityVec &vec)
@@ -27,8 +38,21 @@ std::shared_ptr<Entity> EntityManager::addEntity(const std::string &tag)
     return entity;
 }
 
+std::shared_ptr<Entity> EntityManager::addEntity(const std::string &tag, const ComponentTuple &prototype)
+{
+    auto entity = std::shared_ptr<Entity>(new Entity(m_totalEntities++, tag, prototype));
+    m_entitiesToAdd.push_back(entity);
+    return entity;
+}
+
 const EntityVec &EntityManager::getEntities() const { return m_entities; }
 
+const EntityMap &EntityManager::getEntityMap() const { return m_entityMap; }
+
+const EntityVec &EntityManager::getAddedEntities() const { return m_entitiesAdded; }
+
+const EntityVec &EntityManager::getRemovedEntities() const { return m_entitiesRemoved; }
+
 const EntityVec &EntityManager::getEntities(const std::string &tag) const
 {
     auto it = m_entityMap.find(tag);
@@ -0,0 +1,219 @@
+#include "../include/FrameCapture.h"
+
+#include <SFML/OpenGL.hpp>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // spare buffers kept for reuse once the encoder is done with them
+    constexpr std::size_t MAX_POOL = 8;
+    // screenshots beyond this backlog are dropped rather than piling up memory
+    constexpr std::size_t MAX_QUEUED = 16;
+
+    std::string numbered(const char * prefix, std::size_t n, const char * suffix)
+    {
+        std::string digits = std::to_string(n);
+        if (digits.size() < 4) digits.insert(0, 4 - digits.size(), '0');
+        return prefix + digits + suffix;
+    }
+}
+
+FrameCapture::~FrameCapture()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    // the encoder drains its queue before exiting, so pending shots are still written
+    if (m_encoder.joinable()) m_encoder.join();
+}
+
+void FrameCapture::requestScreenshot(const std::filesystem::path & path)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shotRequests.push_back(path);
+    }
+    m_hasRequests.store(true, std::memory_order_release);
+}
+
+void FrameCapture::setContinuous(unsigned everyNth, std::size_t maxBytes)
+{
+    m_ringBytes.store(maxBytes, std::memory_order_relaxed);
+    m_every.store(everyNth, std::memory_order_relaxed);
+}
+
+void FrameCapture::dumpReplay(const std::filesystem::path & dir)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_dumpDir = dir;
+    }
+    m_hasRequests.store(true, std::memory_order_release);
+}
+
+void FrameCapture::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [&] { return m_jobs.empty() && !m_busy; });
+}
+
+bool FrameCapture::grab(sf::RenderWindow & window, Buffer & out, sf::Vector2u & size)
+{
+    size = window.getSize();
+    if (size.x == 0 || size.y == 0) return false;
+
+    // the readback is the one cost left on the drawing thread: straight from the
+    // backbuffer into the pooled buffer (SFML's copyToImage would allocate an
+    // image every time). out keeps its capacity, so steady state does not
+    // allocate. Rows come out bottom up; the encoder flips them.
+    out.resize(static_cast<std::size_t>(size.x) * size.y * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, static_cast<int>(size.x), static_cast<int>(size.y), GL_RGBA, GL_UNSIGNED_BYTE, out.data());
+    return true;
+}
+
+FrameCapture::Buffer FrameCapture::acquire()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pool.empty()) return {};
+    Buffer b = std::move(m_pool.back());
+    m_pool.pop_back();
+    return b;
+}
+
+void FrameCapture::queue(Job job, bool mayDrop)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (mayDrop && m_jobs.size() >= MAX_QUEUED)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            if (m_pool.size() < MAX_POOL) m_pool.push_back(std::move(job.pixels));
+            return;
+        }
+        m_jobs.push_back(std::move(job));
+        if (!m_encoder.joinable()) m_encoder = std::thread(&FrameCapture::encoderMain, this);
+    }
+    m_wake.notify_one();
+}
+
+void FrameCapture::onFrame(sf::RenderWindow & window)
+{
+    ++m_frames;
+
+    // continuous mode: every Nth frame goes into the ring, reusing its buffers
+    const unsigned    every = m_every.load(std::memory_order_relaxed);
+    const sf::Vector2u size = window.getSize();
+    const std::size_t bytes = static_cast<std::size_t>(size.x) * size.y * 4;
+    const std::size_t frames = every && bytes ? m_ringBytes.load(std::memory_order_relaxed) / bytes : 0;
+    if (frames != m_ring.size())
+    {
+        // buffers still lent out are freed as they come back instead of rejoining
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_ringGeneration;
+        m_returned.clear();
+        m_ring.clear();
+        m_ring.shrink_to_fit();
+        m_ring.resize(frames);
+        m_ringHead = m_ringCount = 0;
+    }
+    if (every && !m_ring.empty() && m_frames % every == 0)
+    {
+        RingFrame & f = m_ring[m_ringHead];
+        if (f.lent)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_returned.empty())
+            {
+                f.pixels = std::move(m_returned.back());
+                m_returned.pop_back();
+                f.lent = false;
+            }
+        }
+        if (f.lent)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (grab(window, f.pixels, f.size))
+        {
+            m_ringHead  = (m_ringHead + 1) % m_ring.size();
+            m_ringCount = std::min(m_ringCount + 1, m_ring.size());
+            m_captured.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (!m_hasRequests.exchange(false, std::memory_order_acquire)) return;
+
+    std::vector<std::filesystem::path> shots;
+    std::filesystem::path              dumpDir;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        shots.swap(m_shotRequests);
+        dumpDir.swap(m_dumpDir);
+    }
+
+    for (auto & path : shots)
+    {
+        Job job{ acquire(), {}, path.empty() ? std::filesystem::path(numbered("screenshot_", ++m_shotIndex, ".png")) : path };
+        if (!grab(window, job.pixels, job.size)) continue;
+        m_captured.fetch_add(1, std::memory_order_relaxed);
+        queue(std::move(job), true);
+    }
+
+    // the ring's buffers are lent as they are, oldest first, which is also the
+    // order the encoder returns them in and the ring refills them
+    if (!dumpDir.empty() && m_ringCount > 0)
+    {
+        ++m_dumpIndex;
+        const std::size_t n     = m_ring.size();
+        const std::size_t first = (m_ringHead + n - m_ringCount) % n;
+        for (std::size_t i = 0; i < m_ringCount; ++i)
+        {
+            RingFrame & f = m_ring[(first + i) % n];
+            const std::string name = numbered("replay_", m_dumpIndex, "_") + numbered("", i, ".png");
+            queue(Job{ std::move(f.pixels), f.size, dumpDir / name, m_ringGeneration }, false);
+            f.pixels = {};
+            f.lent   = true;
+        }
+        m_ringCount = 0;
+    }
+}
+
+void FrameCapture::encoderMain()
+{
+    for (;;)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || !m_jobs.empty(); });
+            if (m_jobs.empty()) return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_busy = true;
+        }
+
+        std::error_code ec;
+        if (job.path.has_parent_path()) std::filesystem::create_directories(job.path.parent_path(), ec);
+
+        // glReadPixels rows are bottom up
+        const std::size_t row = static_cast<std::size_t>(job.size.x) * 4;
+        for (std::size_t top = 0, bottom = job.size.y; top + 1 < bottom; ++top, --bottom)
+            std::swap_ranges(job.pixels.begin() + top * row, job.pixels.begin() + (top + 1) * row,
+                             job.pixels.begin() + (bottom - 1) * row);
+
+        const sf::Image image(job.size, job.pixels.data());
+        if (image.saveToFile(job.path)) m_written.fetch_add(1, std::memory_order_relaxed);
+        else std::cerr << "[Capture] Failed to save " << job.path.string() << "\n";
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (job.ring == m_ringGeneration)   m_returned.push_back(std::move(job.pixels));
+            else if (!job.ring && m_pool.size() < MAX_POOL) m_pool.push_back(std::move(job.pixels));
+            m_busy = false;
+        }
+        m_idle.notify_all();
+    }
+}
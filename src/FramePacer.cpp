@@ -0,0 +1,63 @@
+#include "../include/FramePacer.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+    constexpr auto MIN_SPIN = std::chrono::microseconds(200);
+    constexpr auto MAX_SPIN = std::chrono::microseconds(4000);
+
+    double ms(FramePacer::Clock::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+}
+
+void FramePacer::setTargetFps(unsigned fps)
+{
+    m_period  = fps ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps))
+                    : Clock::duration::zero();
+    m_started = false;
+}
+
+unsigned FramePacer::targetFps() const
+{
+    return m_period.count() ? static_cast<unsigned>(1.0 / std::chrono::duration<double>(m_period).count() + 0.5) : 0;
+}
+
+FramePacer::Clock::time_point FramePacer::wait()
+{
+    auto now = Clock::now();
+    if (!m_started) {
+        m_started   = true;
+        m_deadline  = now;
+        m_lastStart = now;
+        return now;
+    }
+
+    const bool paced = m_period != Clock::duration::zero();
+    if (paced) {
+        m_deadline += m_period;
+        if (now > m_deadline + m_period) {
+            ++m_stats.missed;
+            m_deadline = now;
+        } else {
+            const auto wake = m_deadline - m_spin;
+            if (now < wake) {
+                std::this_thread::sleep_until(wake);
+
+                // the margin jumps to the worst oversleep and decays slowly back down
+                const auto late = Clock::now() - wake;
+                m_spin = late > m_spin ? late : m_spin - (m_spin - late) / 16;
+                m_spin = std::clamp<Clock::duration>(m_spin, MIN_SPIN, MAX_SPIN);
+            }
+            while (Clock::now() < m_deadline) {}
+        }
+    }
+
+    now = Clock::now();
+    if (paced) m_stats.jitter.add(ms(now - m_deadline));
+    m_stats.frameTime.add(ms(now - m_lastStart));
+    m_lastStart = now;
+    return now;
+}
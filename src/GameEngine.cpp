@@ -3,20 +3,72 @@
 #include "../include/Scene_Play.h"
 #include "../include/Scene_Menu.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
 
-GameEngine::GameEngine(const std::string & path)
+namespace {
+    // replay capture (F11 toggles, F12 dumps): every 2nd frame, as many as fit in
+    // 256 MB: 72 frames at 1280x720, the last 2.4 seconds
+    constexpr unsigned    REPLAY_EVERY = 2;
+    constexpr std::size_t REPLAY_BYTES = std::size_t(256) << 20;
+
+    // ended scenes are kept while the renderer may still draw frames they recorded
+    constexpr std::uint64_t SCENE_RELEASE_FRAMES = 2;
+
+    bool isReady(const std::future<void>& f)
+    {
+        return f.valid() && f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    void printFrameStats(std::vector<float> ms)
+    {
+        if (ms.empty()) return;
+        std::sort(ms.begin(), ms.end());
+        const auto at = [&](double q) { return ms[static_cast<std::size_t>(q * (ms.size() - 1))]; };
+        std::cout << "[Replay] " << ms.size() << " frames, mean "
+                  << std::accumulate(ms.begin(), ms.end(), 0.0) / ms.size() << " ms, p50 " << at(0.5)
+                  << " p95 " << at(0.95) << " p99 " << at(0.99) << " max " << ms.back() << " ms\n";
+    }
+
+    void printPacingStats(const FramePacer& pacer, const Histogram& latency)
+    {
+        const auto& s = pacer.stats();
+        if (!s.frameTime.samples()) return;
+        std::cout << "[Pacing] " << pacer.targetFps() << " fps target, frame p50 " << s.frameTime.percentile(0.5)
+                  << " p99 " << s.frameTime.percentile(0.99) << " ms, jitter p99 " << s.jitter.percentile(0.99)
+                  << " max " << s.jitter.max() << " ms, " << s.missed << " missed; input to present p50 "
+                  << latency.percentile(0.5) << " p99 " << latency.percentile(0.99) << " ms\n";
+    }
+}
+
+GameEngine::GameEngine(const std::string & path, bool headless)
+    : m_headless(headless)
+    , m_audio(m_assets, headless ? std::unique_ptr<AudioDevice>(std::make_unique<NullAudioDevice>())
+                                 : std::make_unique<SfmlAudioDevice>())
 {
     init(path);
 }
 
 void GameEngine::init(const std::string & path)
 {
-    m_assets.loadFromFile(path);
+    m_assets.setHeadless(m_headless);
 
-    m_window.create(sf::VideoMode({1280, 720}), "Definitely NOT Mario");
-    m_window.setFramerateLimit(60);
+    // a prebuilt bundle uploads straight from the mapped file; a plain config keeps
+    // decoding textures and sounds in the background while run() uploads them
+    if (AssetBundle::isBundle(path)) m_assets.loadBundle(path);
+    else                             m_assets.beginLoad(path);
 
-    changeScene("Menu", std::make_shared<Scene_Menu>(this));
+    // entity archetypes (Player, Enemy, Bullet), named by the config's Prefabs line
+    if (m_assets.prefabsPath().empty()) std::cerr << "[Engine] No Prefabs line in " << path << "\n";
+    else                                m_prefabs.loadFromFile(m_assets.prefabsPath());
+
+    // headless engines (servers, benchmarks) are handed their scene by the caller
+    if (!m_headless) {
+        m_window.create(sf::VideoMode(m_size), "Definitely NOT Mario");
+        changeScene("Menu", std::make_shared<Scene_Menu>(this));
+    }
 }
 
 std::shared_ptr<Scene> GameEngine::currentScene()
@@ -29,25 +81,109 @@ std::shared_ptr<Scene> GameEngine::currentScene()
 
 bool GameEngine::isRunning()
 {
-    return m_running & m_window.isOpen();
+    return m_running && (m_headless || m_window.isOpen());
 }
 
+// Input and simulation run here; drawing happens in the renderer, on its own
+// thread when m_threadedRender is set, while the next frame is simulated.
 void GameEngine::run() {
+    using Clock = std::chrono::steady_clock;
+    const bool replaying = m_inputMode == InputMode::Replay;
+
+    // a benchmark replay measures the engine, not the pacer; headless runs flat out
+    if (replaying) {
+        m_frameTimes.clear();
+        m_frameTimes.reserve(m_inputLog.length());
+    }
+    m_pacer.setTargetFps(replaying || m_headless ? 0 : TARGET_FPS);
+    m_pacer.resetStats();
+    m_renderer.resetLatency();
+
     m_running = true;
-    while (m_running && m_window.isOpen()) {
+    if (!m_headless) m_renderer.start(m_threadedRender);
+    auto last = Clock::now();
+    while (isRunning()) {
+        m_pacer.wait();
+
+        // input is read as late as possible, right before the simulation that uses it
+        const auto inputTime = Clock::now();
         sUserInput();
         update();
 
-        m_window.clear();
-        if (auto s = currentScene()) s->sRender();
+        if (!m_headless) {
+            if (auto s = currentScene()) s->sRender();
+            m_renderer.frame().setInputTime(inputTime);
+            m_renderer.submit();
+        }
+        m_audio.update(FRAME_DT);
+        ++m_frame;
+
+        // loading and scene swaps go after the frame is out, never between input and display
+        updateLoading();
+
+        if (replaying) {
+            const auto now = Clock::now();
+            m_frameTimes.push_back(std::chrono::duration<float, std::milli>(now - last).count());
+            last = now;
+            if (m_inputLog.finished(m_frame)) quit();
+        }
+    }
+    if (!m_headless) {
+        m_renderer.stop();
+        if (m_window.isOpen()) m_window.close();
+    }
 
-        m_window.display();
+    if (m_inputMode == InputMode::Record) {
+        m_inputLog.setLength(m_frame);
+        if (m_inputLog.save(m_inputLogPath))
+            std::cout << "[Input] Recorded " << m_inputLog.events().size() << " actions over "
+                      << m_frame << " frames to " << m_inputLogPath << "\n";
+    }
+    if (replaying) printFrameStats(m_frameTimes);
+    else if (!m_headless) printPacingStats(m_pacer, m_renderer.latency());
+}
+
+void GameEngine::simulate(std::size_t frames)
+{
+    m_running = true;
+    for (std::size_t i = 0; i < frames && m_running; ++i) {
+        sUserInput();
+        update();
+        m_audio.update(FRAME_DT);
+        ++m_frame;
+        updateLoading();
+        if (m_inputMode == InputMode::Replay && m_inputLog.finished(m_frame)) break;
     }
 }
 
+// asset uploads, texture residency and scene swaps, once per frame
+void GameEngine::updateLoading()
+{
+    if (!m_assets.loaded()) m_assets.updateLoad();
+    m_assets.updateResidency();
+    updateScenes();
+}
+
+bool GameEngine::recordInput(const std::string & path)
+{
+    m_inputLog.clear();
+    m_inputLogPath = path;
+    m_inputMode    = InputMode::Record;
+    return true;
+}
+
+bool GameEngine::replayInput(const std::string & path)
+{
+    if (!m_inputLog.load(path)) return false;
+    m_inputLogPath = path;
+    m_inputMode    = InputMode::Replay;
+    return true;
+}
+
 void GameEngine::sUserInput()
 {
-    while (auto ev = m_window.pollEvent()) {
+    auto scene = currentScene();
+    while (auto ev = m_headless ? std::nullopt : m_window.pollEvent()) {
     const auto& e = *ev;
 
     if (e.is<sf::Event::Closed>()) {
@@ -57,10 +193,15 @@ void GameEngine::sUserInput()
 
     if (const auto* kp = e.getIf<sf::Event::KeyPressed>()) {
         if (kp->scancode == sf::Keyboard::Scancode::X) {
-            sf::Texture backbuffer(m_window.getSize());
-            backbuffer.update(m_window);
-            const bool ok = backbuffer.copyToImage().saveToFile("screenshot.png");
-            (void)ok;
+            m_renderer.requestScreenshot();
+        }
+        if (kp->scancode == sf::Keyboard::Scancode::F11) {
+            m_replayCapture = !m_replayCapture;
+            m_renderer.capture().setContinuous(m_replayCapture ? REPLAY_EVERY : 0, REPLAY_BYTES);
+            std::cerr << "[Capture] Replay capture " << (m_replayCapture ? "on" : "off") << "\n";
+        }
+        if (kp->scancode == sf::Keyboard::Scancode::F12) {
+            m_renderer.capture().dumpReplay();
         }
     }
 
@@ -71,42 +212,137 @@ void GameEngine::sUserInput()
             : e.getIf<sf::Event::KeyReleased>()->scancode;
         const int key = static_cast<int>(scancode);
 
-        const auto& map = currentScene()->getActionMap();
-        const auto it = map.find(key);
-        if (it != map.end()) {
-            const auto at = pressed ? ActionType::Start : ActionType::End;
-            currentScene()->doAction(Action(it->second, at));
+        if (!scene || m_inputMode == InputMode::Replay) continue;
+        if (const ActionId id = scene->getActionMap().find(key)) {
+            const Action action(id, pressed ? ActionType::Start : ActionType::End);
+            if (m_inputMode == InputMode::Record) m_inputLog.record(m_frame, action);
+            scene->doAction(action);
+            scene = currentScene();   // the action may have changed scenes
         }
     }
 }
+
+    if (m_inputMode == InputMode::Replay) {
+        while (auto action = m_inputLog.next(m_frame)) {
+            if (scene) scene->doAction(*action);
+            scene = currentScene();
+        }
+    }
 }
 
 void GameEngine::changeScene(const std::string& sceneName,
                              std::shared_ptr<Scene> scene,
                              bool endCurrentScene)
 {
+    // replaces any preload of the same name; it may share files with this one
+    std::erase_if(m_pendingScenes, [&](PendingScene& p) {
+        if (p.name != sceneName) return false;
+        if (p.loaded.valid()) p.loaded.wait();
+        return true;
+    });
+
+    if (scene) scene->load();
+    setCurrentScene(sceneName, std::move(scene), endCurrentScene);
+}
+
+void GameEngine::preloadScene(const std::string& sceneName, std::shared_ptr<Scene> scene)
+{
+    for (auto& p : m_pendingScenes) {
+        if (p.name != sceneName) continue;
+        if (p.loaded.valid()) p.loaded.wait();   // a load in flight still owns its scene
+        p = PendingScene{ sceneName, std::move(scene), {} };
+        return;
+    }
+    m_pendingScenes.push_back({ sceneName, std::move(scene), {} });
+    updateScenes();
+}
+
+void GameEngine::changeScene(const std::string& sceneName, bool endCurrentScene)
+{
+    auto it = std::find_if(m_pendingScenes.begin(), m_pendingScenes.end(),
+                           [&](const PendingScene& p) { return p.name == sceneName; });
+    if (it == m_pendingScenes.end()) {
+        if (auto s = m_sceneMap.find(sceneName); s != m_sceneMap.end()) setCurrentScene(sceneName, s->second, endCurrentScene);
+        else std::cerr << "[Engine] No scene '" << sceneName << "' to change to\n";
+        return;
+    }
+
+    it->activate   = true;
+    it->endCurrent = endCurrentScene;
+
+    // recorded sessions must switch on the same frame however long the load takes
+    if (deterministic()) {
+        if (!m_assets.loaded()) m_assets.finishLoad();
+        startLoad(*it);
+        it->loaded.wait();
+    }
+    updateScenes();
+}
+
+bool GameEngine::sceneReady(const std::string& sceneName) const
+{
+    for (const auto& p : m_pendingScenes)
+        if (p.name == sceneName) return isReady(p.loaded);
+    return m_sceneMap.count(sceneName) != 0;
+}
+
+void GameEngine::startLoad(PendingScene& pending)
+{
+    if (pending.loaded.valid()) return;
+    if (!m_sceneLoader) m_sceneLoader = std::make_unique<ThreadPool>(1);
+    pending.loaded = m_sceneLoader->submit([scene = pending.scene] { scene->load(); });
+}
+
+void GameEngine::updateScenes()
+{
+    // loads only start once the asset tables stop changing; Scene::load reads them
+    for (std::size_t i = 0; i < m_pendingScenes.size();) {
+        auto& p = m_pendingScenes[i];
+        if (m_assets.loaded()) startLoad(p);
+        if (!p.activate || !isReady(p.loaded)) { ++i; continue; }
+
+        p.loaded.get();
+        PendingScene ready = std::move(p);
+        m_pendingScenes.erase(m_pendingScenes.begin() + static_cast<std::ptrdiff_t>(i));
+        setCurrentScene(ready.name, std::move(ready.scene), ready.endCurrent);
+    }
+
+    std::erase_if(m_endedScenes, [&](const EndedScene& e) { return m_frame >= e.frame + SCENE_RELEASE_FRAMES; });
+}
+
+void GameEngine::setCurrentScene(const std::string& sceneName,
+                                 std::shared_ptr<Scene> scene,
+                                 bool endCurrentScene)
+{
+    // ended scenes leave the map, and are freed once the renderer is done with them
     if (endCurrentScene && !m_currentScene.empty()) {
-        if (auto it = m_sceneMap.find(m_currentScene);
-            it != m_sceneMap.end() && it->second) {
-            it->second->onEnd();
+        if (auto it = m_sceneMap.find(m_currentScene); it != m_sceneMap.end()) {
+            if (it->second) {
+                it->second->onEnd();
+                m_endedScenes.push_back({ std::move(it->second), m_frame });
+            }
+            m_sceneMap.erase(it);
         }
     }
 
-    m_sceneMap[sceneName] = std::move(scene);
+    const bool resumed = m_sceneMap.count(sceneName) && m_sceneMap[sceneName] == scene;
+    if (!resumed) {
+        if (auto it = m_sceneMap.find(sceneName); it != m_sceneMap.end() && it->second)
+            m_endedScenes.push_back({ std::move(it->second), m_frame });
+        m_sceneMap[sceneName] = scene;
+    }
     m_currentScene = sceneName;
 
-    if (auto it = m_sceneMap.find(m_currentScene);
-        it != m_sceneMap.end() && it->second) {
-        it->second->init();
-    }
+    if (scene && !resumed) scene->init();
 }
 
 void GameEngine::quit()
 {
+    // the window is closed by run() once the render thread has stopped
     m_running = false;
-    if (m_window.isOpen()) m_window.close();
+    if (!m_renderer.isThreaded() && m_window.isOpen()) m_window.close();
 }
 
 void GameEngine::update() {
-    if (auto s = currentScene()) s->update();
+    if (auto s = currentScene()) s->simulate(m_simulationSpeed);
 }
@@ -0,0 +1,127 @@
+#include "../include/InputLog.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <unordered_map>
+
+namespace {
+    constexpr char          MAGIC[8] = { 'S', 'F', 'I', 'N', 'P', 'U', 'T', 0 };
+    constexpr std::uint32_t VERSION  = 1;
+
+    // LEB128: 7 bits per byte, high bit set on all but the last
+    void putVarint(std::string & out, std::uint64_t v)
+    {
+        while (v >= 0x80) { out += static_cast<char>((v & 0x7f) | 0x80); v >>= 7; }
+        out += static_cast<char>(v);
+    }
+
+    bool getVarint(const std::string & in, std::size_t & at, std::uint64_t & v)
+    {
+        v = 0;
+        for (int shift = 0; shift < 64 && at < in.size(); shift += 7)
+        {
+            const auto b = static_cast<unsigned char>(in[at++]);
+            v |= std::uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+}
+
+// MAGIC, VERSION, length, name count, names (length + bytes), event count,
+// then per event: frame delta, (name index << 1 | end)
+bool InputLog::save(const std::string & path) const
+{
+    std::unordered_map<ActionId, std::uint32_t> seen;       // ActionId -> name index
+    std::string names, events;
+    std::uint64_t frame = 0;
+    for (const Event & e : m_events)
+    {
+        auto [it, added] = seen.try_emplace(e.action, static_cast<std::uint32_t>(seen.size()));
+        if (added)
+        {
+            const std::string & name = Action::nameOf(e.action);
+            putVarint(names, name.size());
+            names += name;
+        }
+        putVarint(events, e.frame - frame);
+        putVarint(events, std::uint64_t(it->second) << 1 | (e.type == ActionType::End ? 1u : 0u));
+        frame = e.frame;
+    }
+
+    std::string out(MAGIC, sizeof(MAGIC));
+    out.append(reinterpret_cast<const char *>(&VERSION), sizeof(VERSION));
+    putVarint(out, m_length);
+    putVarint(out, seen.size());
+    out += names;
+    putVarint(out, m_events.size());
+    out += events;
+
+    std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+    if (!fout || !fout.write(out.data(), static_cast<std::streamsize>(out.size())))
+    {
+        std::cerr << "[Input] Cannot write input log: " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool InputLog::load(const std::string & path)
+{
+    clear();
+    std::ifstream fin(path, std::ios::binary);
+    if (!fin)
+    {
+        std::cerr << "[Input] Cannot open input log: " << path << "\n";
+        return false;
+    }
+    const std::string in{ std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>() };
+
+    std::uint32_t version = 0;
+    if (in.size() < sizeof(MAGIC) + sizeof(version) || std::memcmp(in.data(), MAGIC, sizeof(MAGIC)) != 0)
+    {
+        std::cerr << "[Input] Not an input log: " << path << "\n";
+        return false;
+    }
+    std::memcpy(&version, in.data() + sizeof(MAGIC), sizeof(version));
+    if (version != VERSION)
+    {
+        std::cerr << "[Input] Not a version " << VERSION << " input log: " << path << "\n";
+        return false;
+    }
+
+    std::size_t   at = sizeof(MAGIC) + sizeof(version);
+    std::uint64_t nameCount = 0, eventCount = 0;
+    bool ok = getVarint(in, at, m_length) && getVarint(in, at, nameCount);
+
+    std::vector<ActionId> ids;
+    for (std::uint64_t i = 0; ok && i < nameCount; ++i)
+    {
+        std::uint64_t len = 0;
+        ok = getVarint(in, at, len) && len <= in.size() - at;
+        if (ok) ids.push_back(Action::intern(in.substr(at, len)));
+        at += ok ? len : 0;
+    }
+
+    ok = ok && getVarint(in, at, eventCount) && eventCount <= in.size() - at;
+    if (ok) m_events.reserve(eventCount);
+
+    std::uint64_t frame = 0;
+    for (std::uint64_t i = 0; ok && i < eventCount; ++i)
+    {
+        std::uint64_t delta = 0, packed = 0;
+        ok = getVarint(in, at, delta) && getVarint(in, at, packed) && (packed >> 1) < ids.size();
+        if (!ok) break;
+        frame += delta;
+        m_events.push_back({ frame, ids[packed >> 1], (packed & 1) ? ActionType::End : ActionType::Start });
+    }
+
+    if (!ok)
+    {
+        std::cerr << "[Input] Truncated input log: " << path << "\n";
+        clear();
+    }
+    return ok;
+}
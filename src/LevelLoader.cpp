@@ -0,0 +1,282 @@
+#include "../include/LevelLoader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+    constexpr char          MAGIC[8] = { 'S', 'F', 'L', 'E', 'V', 'E', 'L', 0 };
+    constexpr std::uint32_t VERSION  = 1;
+
+    struct CacheHeader
+    {
+        char              magic[8];
+        std::uint32_t     version;
+        std::uint32_t     nameBytes;       // NUL-terminated names, back to back
+        std::uint64_t     sourceSize;
+        std::int64_t      sourceTime;
+        std::uint64_t     sourceHash;
+        std::uint32_t     nameCount;
+        std::uint32_t     tileCount;
+        std::uint32_t     decCount;
+        std::uint32_t     lightCount;
+        LevelData::Player player;
+    };
+
+    static_assert(std::is_trivially_copyable_v<CacheHeader>);
+    static_assert(std::is_trivially_copyable_v<LevelData::Tile>);
+    static_assert(std::is_trivially_copyable_v<LevelData::Light>);
+
+    std::uint64_t fnv1a(std::string_view s)
+    {
+        std::uint64_t h = 0xcbf29ce484222325ull;
+        for (unsigned char c : s) h = (h ^ c) * 0x100000001b3ull;
+        return h;
+    }
+
+    // next whitespace-separated token of line, consumed from its front
+    std::string_view token(std::string_view & line)
+    {
+        std::size_t i = 0;
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
+        std::size_t j = i;
+        while (j < line.size() && line[j] != ' ' && line[j] != '\t' && line[j] != '\r') ++j;
+        const std::string_view t = line.substr(i, j - i);
+        line.remove_prefix(j);
+        return t;
+    }
+
+    template <class T>
+    bool number(std::string_view & line, T & out)
+    {
+        const std::string_view t = token(line);
+        const auto res = std::from_chars(t.data(), t.data() + t.size(), out);
+        return !t.empty() && res.ec == std::errc{} && res.ptr == t.data() + t.size();
+    }
+
+    template <class T>
+    bool readArray(std::ifstream & in, std::vector<T> & out, std::uint32_t count)
+    {
+        out.resize(count);
+        return static_cast<bool>(in.read(reinterpret_cast<char *>(out.data()),
+                                         static_cast<std::streamsize>(count * sizeof(T))));
+    }
+
+    template <class T>
+    void writeArray(std::ofstream & out, const std::vector<T> & v)
+    {
+        out.write(reinterpret_cast<const char *>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T)));
+    }
+
+    // reads the cache if accept(header) agrees it matches the source
+    template <class Accept>
+    bool readCache(const std::string & file, LevelData & out, Accept accept)
+    {
+        std::ifstream in(file, std::ios::binary);
+        CacheHeader h{};
+        if (!in || !in.read(reinterpret_cast<char *>(&h), sizeof(h))
+            || std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.version != VERSION || !accept(h))
+            return false;
+
+        std::string names(h.nameBytes, '\0');
+        if (!in.read(names.data(), static_cast<std::streamsize>(names.size()))
+            || !readArray(in, out.tiles, h.tileCount)
+            || !readArray(in, out.decs, h.decCount)
+            || !readArray(in, out.lights, h.lightCount))
+            return false;
+
+        out.names.clear();
+        out.names.reserve(h.nameCount);
+        for (std::size_t at = 0; at < names.size() && out.names.size() < h.nameCount;)
+        {
+            const std::size_t end = names.find('\0', at);
+            if (end == std::string::npos) break;
+            out.names.emplace_back(names, at, end - at);
+            at = end + 1;
+        }
+        out.player = h.player;
+
+        // indices are trusted by the scene, so a damaged cache is rejected here
+        const auto bad = [&](const LevelData::Tile & t) { return t.anim >= out.names.size(); };
+        return out.names.size() == h.nameCount
+            && std::none_of(out.tiles.begin(), out.tiles.end(), bad)
+            && std::none_of(out.decs.begin(), out.decs.end(), bad)
+            && (!out.player.present || out.player.weapon < out.names.size());
+    }
+
+    bool writeCache(const std::string & file, const LevelData & level,
+                    std::uint64_t size, std::int64_t time, std::uint64_t hash)
+    {
+        std::string names;
+        for (const auto & n : level.names) { names += n; names += '\0'; }
+
+        CacheHeader h{};
+        std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.version    = VERSION;
+        h.nameBytes  = static_cast<std::uint32_t>(names.size());
+        h.sourceSize = size;
+        h.sourceTime = time;
+        h.sourceHash = hash;
+        h.nameCount  = static_cast<std::uint32_t>(level.names.size());
+        h.tileCount  = static_cast<std::uint32_t>(level.tiles.size());
+        h.decCount   = static_cast<std::uint32_t>(level.decs.size());
+        h.lightCount = static_cast<std::uint32_t>(level.lights.size());
+        h.player     = level.player;
+
+        // written aside and renamed, so a crash never leaves a half cache behind
+        const std::string tmp = file + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out) return false;
+            out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+            out.write(names.data(), static_cast<std::streamsize>(names.size()));
+            writeArray(out, level.tiles);
+            writeArray(out, level.decs);
+            writeArray(out, level.lights);
+            if (!out) return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, file, ec);
+        return !ec;
+    }
+}
+
+bool LevelLoader::parse(std::string_view text, const std::string & path, LevelData & out)
+{
+    out = {};
+
+    // names are interned as views into text; only distinct names allocate
+    std::unordered_map<std::string_view, std::uint32_t> ids;
+    const auto intern = [&](std::string_view name)
+    {
+        auto [it, added] = ids.try_emplace(name, static_cast<std::uint32_t>(out.names.size()));
+        if (added) out.names.emplace_back(name);
+        return it->second;
+    };
+    out.tiles.reserve(static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n')) + 1);
+
+    std::size_t ln = 0;
+    bool clean = true;
+    while (!text.empty())
+    {
+        const std::size_t nl = text.find('\n');
+        std::string_view line = text.substr(0, nl);
+        text.remove_prefix(nl == std::string_view::npos ? text.size() : nl + 1);
+        ++ln;
+
+        const std::string_view kind = token(line);
+        if (kind.empty() || kind.front() == '#') continue;
+
+        bool ok = true;
+        if (kind == "Tile" || kind == "Dec")
+        {
+            const std::string_view name = token(line);
+            LevelData::Tile t{};
+            ok = !name.empty() && number(line, t.x) && number(line, t.y);
+            if (ok)
+            {
+                t.anim = intern(name);
+                (kind == "Tile" ? out.tiles : out.decs).push_back(t);
+            }
+        }
+        else if (kind == "Player")
+        {
+            auto & p = out.player;
+            ok = number(line, p.x) && number(line, p.y) && number(line, p.cw) && number(line, p.ch)
+              && number(line, p.speed) && number(line, p.jump) && number(line, p.maxSpeed)
+              && number(line, p.gravity);
+            const std::string_view weapon = token(line);
+            ok = ok && !weapon.empty();
+            if (ok)
+            {
+                p.weapon  = intern(weapon);
+                p.present = 1;
+            }
+        }
+        else if (kind == "Light")
+        {
+            LevelData::Light l{};
+            int r = 255, g = 255, b = 255;
+            l.intensity = 1.f;
+            ok = number(line, l.x) && number(line, l.y) && number(line, l.radius)
+              && number(line, r) && number(line, g) && number(line, b);
+            std::string_view rest = line;
+            if (!token(rest).empty()) ok = ok && number(line, l.intensity);
+            if (ok)
+            {
+                l.r = static_cast<std::uint8_t>(std::clamp(r, 0, 255));
+                l.g = static_cast<std::uint8_t>(std::clamp(g, 0, 255));
+                l.b = static_cast<std::uint8_t>(std::clamp(b, 0, 255));
+                l.a = 255;
+                out.lights.push_back(l);
+            }
+        }
+        else
+        {
+            std::cerr << "[Level] " << path << ":" << ln << ": unknown record '" << kind << "'\n";
+            clean = false;
+            continue;
+        }
+
+        if (!ok)
+        {
+            std::cerr << "[Level] " << path << ":" << ln << ": bad " << kind << " record\n";
+            clean = false;
+        }
+    }
+    return clean;
+}
+
+bool LevelLoader::load(const std::string & path, LevelData & out, Info * info)
+{
+    const auto start = std::chrono::steady_clock::now();
+    Info local;
+    Info & result = info ? *info : local;
+    result = {};
+    const auto finish = [&] {
+        result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return true;
+    };
+
+    std::error_code ec;
+    const std::uint64_t size = std::filesystem::file_size(path, ec);
+    const std::int64_t  time = ec ? 0 : static_cast<std::int64_t>(
+        std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+    if (ec)
+    {
+        std::cerr << "[Level] Cannot open " << path << "\n";
+        return false;
+    }
+
+    // unchanged since the cache was written: the text is not even read
+    const std::string cache = cachePath(path);
+    if (readCache(cache, out, [&](const CacheHeader & h) { return h.sourceSize == size && h.sourceTime == time; }))
+    {
+        result.fromCache = true;
+        return finish();
+    }
+
+    std::ifstream fin(path, std::ios::binary);
+    std::string text(size, '\0');
+    if (!fin || !fin.read(text.data(), static_cast<std::streamsize>(size)))
+    {
+        std::cerr << "[Level] Cannot read " << path << "\n";
+        return false;
+    }
+    const std::uint64_t hash = fnv1a(text);
+
+    // touched but identical (checkout, copy): reuse the cache and refresh its stamp
+    if (readCache(cache, out, [&](const CacheHeader & h) { return h.sourceSize == size && h.sourceHash == hash; }))
+        result.fromCache = true;
+    else if (!parse(text, path, out))
+        return finish();    // loads what parsed, but is not cached: the errors show again next time
+
+    result.cacheWritten = writeCache(cache, out, size, time, hash);
+    return finish();
+}
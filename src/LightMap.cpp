@@ -0,0 +1,424 @@
+#include "../include/LightMap.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // contributions are fixed point so subtracting a light restores the sum exactly
+    constexpr std::int32_t SCALE = 16;
+    // cells kept around the followed area on each side; the window moves
+    // once the area gets closer than that to its edge
+    constexpr int MARGIN = 8;
+    // more dirty rects than this in a frame are merged into their bounds
+    constexpr std::size_t MAX_DIRTY = 8;
+
+    // octant transforms for recursive shadowcasting
+    constexpr int OCTANTS[4][8] = {
+        { 1,  0,  0, -1, -1,  0,  0,  1 },
+        { 0,  1, -1,  0,  0, -1,  1,  0 },
+        { 0,  1,  1,  0,  0, -1, -1,  0 },
+        { 1,  0,  0,  1, -1,  0,  0, -1 },
+    };
+
+    int wrap(int v, int n)
+    {
+        const int r = v % n;
+        return r < 0 ? r + n : r;
+    }
+
+    sf::IntRect intersect(const sf::IntRect & a, const sf::IntRect & b)
+    {
+        const int x0 = std::max(a.position.x, b.position.x);
+        const int y0 = std::max(a.position.y, b.position.y);
+        const int x1 = std::min(a.position.x + a.size.x, b.position.x + b.size.x);
+        const int y1 = std::min(a.position.y + a.size.y, b.position.y + b.size.y);
+        return { { x0, y0 }, { std::max(0, x1 - x0), std::max(0, y1 - y0) } };
+    }
+
+    bool empty(const sf::IntRect & r)
+    {
+        return r.size.x <= 0 || r.size.y <= 0;
+    }
+
+    std::uint8_t channel(std::uint8_t ambient, std::int32_t light)
+    {
+        return static_cast<std::uint8_t>(std::clamp<std::int32_t>(ambient + light / SCALE, 0, 255));
+    }
+}
+
+LightMap::LightMap(const sf::Vector2f & cellSize)
+    : m_cellSize(cellSize)
+    , m_slot(RenderImage::nextId())
+{
+}
+
+std::uint64_t LightMap::key(int cx, int cy)
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32)
+         | static_cast<std::uint32_t>(cy);
+}
+
+sf::IntRect LightMap::square(const Light & l)
+{
+    return { { l.cell.x - l.radius, l.cell.y - l.radius }, { 2 * l.radius + 1, 2 * l.radius + 1 } };
+}
+
+sf::Vector2i LightMap::cellOf(const sf::Vector2f & world) const
+{
+    return { static_cast<int>(std::floor(world.x / m_cellSize.x)),
+             static_cast<int>(std::floor(world.y / m_cellSize.y)) };
+}
+
+bool LightMap::inWindow(int cx, int cy) const
+{
+    return cx >= m_window.position.x && cx < m_window.position.x + m_window.size.x
+        && cy >= m_window.position.y && cy < m_window.position.y + m_window.size.y;
+}
+
+// storage wraps around, so a cell keeps its slot while the window moves
+std::size_t LightMap::index(int cx, int cy) const
+{
+    return static_cast<std::size_t>(wrap(cy, m_window.size.y) * m_window.size.x + wrap(cx, m_window.size.x));
+}
+
+// outside the window the occluder set answers, so casts do not depend on where the window is
+bool LightMap::opaque(int cx, int cy) const
+{
+    if (inWindow(cx, cy)) return m_opaque[index(cx, cy)] != 0;
+    return m_occluders.count(key(cx, cy)) != 0;
+}
+
+void LightMap::markDirty(const sf::IntRect & cells)
+{
+    const sf::IntRect r = intersect(cells, m_window);
+    if (empty(r)) return;
+    m_dirty.push_back(r);
+    if (m_dirty.size() <= MAX_DIRTY) return;
+
+    sf::IntRect all = m_dirty.front();
+    for (const auto & d : m_dirty)
+    {
+        const int x0 = std::min(all.position.x, d.position.x);
+        const int y0 = std::min(all.position.y, d.position.y);
+        const int x1 = std::max(all.position.x + all.size.x, d.position.x + d.size.x);
+        const int y1 = std::max(all.position.y + all.size.y, d.position.y + d.size.y);
+        all = { { x0, y0 }, { x1 - x0, y1 - y0 } };
+    }
+    m_dirty.assign(1, all);
+}
+
+// fills cells that just entered the window from the occluder set and the
+// lights' cached contributions; nothing is re-cast
+void LightMap::refresh(const sf::IntRect & cells)
+{
+    for (int cy = cells.position.y; cy < cells.position.y + cells.size.y; ++cy)
+    {
+        for (int cx = cells.position.x; cx < cells.position.x + cells.size.x; ++cx)
+        {
+            const std::size_t i = index(cx, cy);
+            m_opaque[i] = m_occluders.count(key(cx, cy)) ? 1 : 0;
+            m_accum[i * 3 + 0] = m_accum[i * 3 + 1] = m_accum[i * 3 + 2] = 0;
+        }
+    }
+    for (const auto & [id, s] : m_lights)
+        if (s.hasApplied) apply(s, s.applied, 1, cells);
+    markDirty(cells);
+}
+
+void LightMap::follow(const sf::FloatRect & area)
+{
+    const sf::Vector2i a = cellOf(area.position);
+    const sf::Vector2i b = cellOf(area.position + area.size);
+    const sf::IntRect  view{ a, { b.x - a.x + 1, b.y - a.y + 1 } };
+    const sf::Vector2i size{ view.size.x + 2 * MARGIN, view.size.y + 2 * MARGIN };
+    const sf::Vector2i centred{ a.x - MARGIN, a.y - MARGIN };
+
+    if (size != m_window.size)
+    {
+        // first use or a new view size: start over with a window of the new size
+        m_window = { centred, size };
+        const auto cells = static_cast<std::size_t>(size.x * size.y);
+        m_opaque.assign(cells, 0);
+        m_accum.assign(cells * 3, 0);
+        m_dirty.clear();
+        m_image.reset();
+        refresh(m_window);
+        return;
+    }
+    if (intersect(view, m_window) == view) return;
+
+    const sf::IntRect old = m_window;
+    m_window.position = centred;
+    const sf::IntRect kept = intersect(old, m_window);
+    if (empty(kept))
+    {
+        refresh(m_window);
+        return;
+    }
+
+    // columns that scrolled in, full height, then rows that scrolled in over the kept columns
+    const sf::Vector2i d = m_window.position - old.position;
+    if (d.x < 0) refresh({ m_window.position, { -d.x, size.y } });
+    if (d.x > 0) refresh({ { old.position.x + size.x, m_window.position.y }, { d.x, size.y } });
+    if (d.y < 0) refresh({ { kept.position.x, m_window.position.y }, { kept.size.x, -d.y } });
+    if (d.y > 0) refresh({ { kept.position.x, old.position.y + size.y }, { kept.size.x, d.y } });
+}
+
+void LightMap::touchLights(const sf::Vector2i & cell)
+{
+    for (auto & [id, s] : m_lights)
+    {
+        const auto near = [&](const Light & l)
+        {
+            return std::abs(cell.x - l.cell.x) <= l.radius && std::abs(cell.y - l.cell.y) <= l.radius;
+        };
+        if (near(s.light) || (s.hasApplied && near(s.applied))) s.dirty = true;
+    }
+}
+
+void LightMap::addOccluder(const sf::Vector2i & cell)
+{
+    if (++m_occluders[key(cell.x, cell.y)] != 1) return;
+    if (inWindow(cell.x, cell.y)) m_opaque[index(cell.x, cell.y)] = 1;
+    touchLights(cell);
+}
+
+void LightMap::removeOccluder(const sf::Vector2i & cell)
+{
+    auto it = m_occluders.find(key(cell.x, cell.y));
+    if (it == m_occluders.end() || --it->second != 0) return;
+    m_occluders.erase(it);
+    if (inWindow(cell.x, cell.y)) m_opaque[index(cell.x, cell.y)] = 0;
+    touchLights(cell);
+}
+
+LightMap::LightId LightMap::add(const Light & light)
+{
+    const LightId id = m_nextId++;
+    m_lights[id].light = light;
+    return id;
+}
+
+void LightMap::set(LightId id, const Light & light)
+{
+    auto it = m_lights.find(id);
+    if (it == m_lights.end() || it->second.light == light) return;
+    it->second.light = light;
+    it->second.dirty = true;
+}
+
+void LightMap::remove(LightId id)
+{
+    auto it = m_lights.find(id);
+    if (it == m_lights.end()) return;
+    if (it->second.hasApplied)
+    {
+        apply(it->second, it->second.applied, -1, m_window);
+        markDirty(square(it->second.applied));
+    }
+    m_lights.erase(it);
+}
+
+void LightMap::clear()
+{
+    m_lights.clear();
+    m_occluders.clear();
+    m_opaque.clear();
+    m_accum.clear();
+    m_dirty.clear();
+    m_window = {};
+    m_image.reset();
+}
+
+void LightMap::setAmbient(const sf::Color & ambient)
+{
+    if (ambient == m_ambient) return;
+    m_ambient = ambient;
+    markDirty(m_window);
+}
+
+void LightMap::lightCell(LightState & s, int dx, int dy)
+{
+    const Light & l = s.light;
+    const float   R = l.radius + 0.5f;
+    const float   t = 1.f - static_cast<float>(dx * dx + dy * dy) / (R * R);
+    if (t <= 0.f) return;
+
+    const float f    = l.intensity * t * static_cast<float>(SCALE);
+    const int   side = 2 * l.radius + 1;
+    std::int32_t * c = &s.contrib[static_cast<std::size_t>(((dy + l.radius) * side + dx + l.radius) * 3)];
+    // octants share their edges, so assign rather than accumulate
+    c[0] = static_cast<std::int32_t>(l.color.r * f);
+    c[1] = static_cast<std::int32_t>(l.color.g * f);
+    c[2] = static_cast<std::int32_t>(l.color.b * f);
+}
+
+void LightMap::castOctant(LightState & s, int row, float start, float end, int xx, int xy, int yx, int yy)
+{
+    if (start < end) return;
+
+    const int          r = s.light.radius;
+    const sf::Vector2i c = s.light.cell;
+    float newStart = 0.f;
+
+    for (int j = row; j <= r; ++j)
+    {
+        bool blocked = false;
+        for (int dx = -j, dy = -j; dx <= 0; ++dx)
+        {
+            const int   X      = dx * xx + dy * xy;
+            const int   Y      = dx * yx + dy * yy;
+            const float lSlope = (dx - 0.5f) / (dy + 0.5f);
+            const float rSlope = (dx + 0.5f) / (dy - 0.5f);
+            if (start < rSlope) continue;
+            if (end > lSlope)   break;
+
+            // walls are lit themselves but stop the light behind them
+            lightCell(s, X, Y);
+            const bool wall = opaque(c.x + X, c.y + Y);
+            if (blocked)
+            {
+                if (wall) { newStart = rSlope; continue; }
+                blocked = false;
+                start   = newStart;
+            }
+            else if (wall && j < r)
+            {
+                blocked = true;
+                castOctant(s, j + 1, start, lSlope, xx, xy, yx, yy);
+                newStart = rSlope;
+            }
+        }
+        if (blocked) break;
+    }
+}
+
+void LightMap::cast(LightState & s)
+{
+    const int side = 2 * s.light.radius + 1;
+    s.contrib.assign(static_cast<std::size_t>(side * side * 3), 0);
+    lightCell(s, 0, 0);
+    for (int o = 0; o < 8; ++o)
+        castOctant(s, 1, 1.f, 0.f, OCTANTS[0][o], OCTANTS[1][o], OCTANTS[2][o], OCTANTS[3][o]);
+    m_cellsRelit += static_cast<std::size_t>(side * side);
+}
+
+void LightMap::apply(const LightState & s, const Light & at, int sign, const sf::IntRect & clip)
+{
+    const sf::IntRect r = intersect(intersect(square(at), clip), m_window);
+    const int side = 2 * at.radius + 1;
+    for (int cy = r.position.y; cy < r.position.y + r.size.y; ++cy)
+    {
+        const int dy = cy - at.cell.y;
+        for (int cx = r.position.x; cx < r.position.x + r.size.x; ++cx)
+        {
+            const int dx = cx - at.cell.x;
+            const std::int32_t * c = &s.contrib[static_cast<std::size_t>(((dy + at.radius) * side + dx + at.radius) * 3)];
+            std::int32_t * a = &m_accum[index(cx, cy) * 3];
+            a[0] += sign * c[0];
+            a[1] += sign * c[1];
+            a[2] += sign * c[2];
+        }
+    }
+}
+
+bool LightMap::update()
+{
+    m_cellsRelit = 0;
+
+    for (auto & [id, s] : m_lights)
+    {
+        if (!s.dirty) continue;
+        if (s.hasApplied)
+        {
+            apply(s, s.applied, -1, m_window);
+            markDirty(square(s.applied));
+            s.hasApplied = false;
+        }
+
+        // lights away from the window stay dirty until it reaches them
+        if (empty(intersect(square(s.light), m_window))) continue;
+        cast(s);
+        apply(s, s.light, 1, m_window);
+        markDirty(square(s.light));
+        s.applied    = s.light;
+        s.hasApplied = true;
+        s.dirty      = false;
+    }
+
+    if (m_dirty.empty()) return false;
+    writePixels();
+    m_dirty.clear();
+    return true;
+}
+
+void LightMap::writePixels()
+{
+    const sf::Vector2u size{ static_cast<unsigned>(m_window.size.x), static_cast<unsigned>(m_window.size.y) };
+
+    // frames in flight keep the previous image, so changes go into a copy;
+    // the renderer only re-uploads the rects listed in it
+    std::shared_ptr<RenderImage> next;
+    if (m_image && m_image->size == size)
+    {
+        next = std::make_shared<RenderImage>(*m_image);
+        next->base = m_image->version;
+    }
+    else
+    {
+        next = std::make_shared<RenderImage>();
+        next->size = size;
+        next->pixels.assign(static_cast<std::size_t>(size.x) * size.y * 4, 255);
+        next->base = 0;
+        m_dirty.assign(1, m_window);
+    }
+    next->slot     = m_slot;
+    next->version  = m_image ? m_image->version + 1 : 1;
+    next->repeated = true;
+    next->dirty.clear();
+
+    for (const auto & r : m_dirty)
+    {
+        for (int cy = r.position.y; cy < r.position.y + r.size.y; ++cy)
+        {
+            for (int cx = r.position.x; cx < r.position.x + r.size.x; ++cx)
+            {
+                const std::size_t i = index(cx, cy);
+                std::uint8_t * px = &next->pixels[i * 4];
+                px[0] = channel(m_ambient.r, m_accum[i * 3 + 0]);
+                px[1] = channel(m_ambient.g, m_accum[i * 3 + 1]);
+                px[2] = channel(m_ambient.b, m_accum[i * 3 + 2]);
+                px[3] = 255;
+            }
+        }
+
+        // the rect in texels, split where it wraps past the image edge
+        const int tx = wrap(r.position.x, m_window.size.x), ty = wrap(r.position.y, m_window.size.y);
+        const int wx = std::min(r.size.x, m_window.size.x - tx), wy = std::min(r.size.y, m_window.size.y - ty);
+        for (const auto & x : { sf::Vector2i{ tx, wx }, sf::Vector2i{ 0, r.size.x - wx } })
+            for (const auto & y : { sf::Vector2i{ ty, wy }, sf::Vector2i{ 0, r.size.y - wy } })
+                if (x.y > 0 && y.y > 0) next->dirty.push_back({ { x.x, y.x }, { x.y, y.y } });
+    }
+    m_image = std::move(next);
+}
+
+void LightMap::quad(sf::Vertex * out) const
+{
+    const sf::Vector2f p{ m_window.position.x * m_cellSize.x, m_window.position.y * m_cellSize.y };
+    const sf::Vector2f s{ m_window.size.x * m_cellSize.x, m_window.size.y * m_cellSize.y };
+
+    // the image wraps (repeated texture), so the window starts wherever its first cell is stored
+    const sf::Vector2f t0{ static_cast<float>(wrap(m_window.position.x, std::max(1, m_window.size.x))),
+                           static_cast<float>(wrap(m_window.position.y, std::max(1, m_window.size.y))) };
+    const sf::Vector2f t1{ t0.x + m_window.size.x, t0.y + m_window.size.y };
+
+    const sf::Vertex tl{ p,                    sf::Color::White, t0 };
+    const sf::Vertex tr{ { p.x + s.x, p.y },   sf::Color::White, { t1.x, t0.y } };
+    const sf::Vertex bl{ { p.x, p.y + s.y },   sf::Color::White, { t0.x, t1.y } };
+    const sf::Vertex br{ p + s,                sf::Color::White, t1 };
+    out[0] = tl; out[1] = tr; out[2] = bl;
+    out[3] = bl; out[4] = tr; out[5] = br;
+}
+
+std::size_t LightMap::lightCount() const { return m_lights.size(); }
+std::size_t LightMap::cellsRelit() const { return m_cellsRelit; }
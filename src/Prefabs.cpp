@@ -0,0 +1,147 @@
+#include "../include/Prefabs.h"
+
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    // config lifespans and intervals are counted in 60 Hz frames
+    constexpr float FRAMES_PER_SECOND = 60.f;
+
+    bool isCommentOrBlank(const std::string& s) {
+        for (char ch : s) {
+            if (ch == '#') return true;
+            if (!std::isspace(static_cast<unsigned char>(ch))) return false;
+        }
+        return true;
+    }
+
+    sf::Color readColor(std::istream& in) {
+        int r = 0, g = 0, b = 0;
+        in >> r >> g >> b;
+        return sf::Color(static_cast<std::uint8_t>(r), static_cast<std::uint8_t>(g), static_cast<std::uint8_t>(b));
+    }
+}
+
+bool Prefabs::loadFromFile(const std::string& path) {
+    std::ifstream fin(path);
+    if (!fin) {
+        std::cerr << "[Prefabs] Cannot open config: " << path << "\n";
+        return false;
+    }
+
+    bool ok = true;
+    std::string line;
+    std::size_t ln = 0;
+    while (std::getline(fin, line)) {
+        ++ln;
+        if (!isCommentOrBlank(line)) ok = parseLine(line, ln) && ok;
+    }
+    return ok;
+}
+
+bool Prefabs::parseLine(const std::string& line, std::size_t ln) {
+    std::istringstream iss(line);
+    std::string kind;
+    iss >> kind;
+
+    float shapeRadius = 0.f, collisionRadius = 0.f, thickness = 0.f;
+    Prefab p;
+    std::string tag;
+
+    if (kind == "Player" || kind == "Bullet") {
+        float speed = 0.f, lifespan = 0.f;
+        std::size_t points = 0;
+        iss >> shapeRadius >> collisionRadius >> speed;
+        const sf::Color fill    = readColor(iss);
+        const sf::Color outline = readColor(iss);
+        iss >> thickness >> points;
+        if (kind == "Bullet") iss >> lifespan;
+        if (!iss || points < 3) {
+            std::cerr << "[Prefabs] Bad " << kind << " line " << ln << "\n";
+            return false;
+        }
+
+        p.add<CShape>(shapeRadius, static_cast<int>(points), fill, outline, thickness);
+        p.speedMin  = p.speedMax  = speed;
+        p.pointsMin = p.pointsMax = points;
+        if (kind == "Player") {
+            p.add<CInput>();
+            tag = "player";
+        } else {
+            p.add<CLifespan>(lifespan / FRAMES_PER_SECOND);
+            tag = "bullet";
+        }
+    } else if (kind == "Enemy") {
+        float childLifespan = 0.f, interval = 0.f;
+        iss >> shapeRadius >> collisionRadius >> p.speedMin >> p.speedMax;
+        const sf::Color outline = readColor(iss);
+        iss >> thickness >> p.pointsMin >> p.pointsMax >> childLifespan >> interval;
+        if (!iss || p.pointsMin < 3 || p.pointsMax < p.pointsMin || p.speedMax < p.speedMin) {
+            std::cerr << "[Prefabs] Bad Enemy line " << ln << "\n";
+            return false;
+        }
+
+        // enemies have no fill in the config; spawners pick one per instance
+        p.add<CShape>(shapeRadius, static_cast<int>(p.pointsMin), sf::Color::Black, outline, thickness);
+        p.childLifespan = childLifespan / FRAMES_PER_SECOND;
+        p.interval      = interval / FRAMES_PER_SECOND;
+        tag = "enemy";
+    } else {
+        return true;
+    }
+
+    p.add<CTransform>();
+    p.add<CBoundingBox>(Vec2(collisionRadius * 2.f, collisionRadius * 2.f));
+    p.tag = tag;
+    m_prefabs.set(kind, std::move(p));
+    return true;
+}
+
+Prefab& Prefabs::define(const std::string& name, const std::string& tag) {
+    Prefab p;
+    p.tag = tag;
+    p.add<CTransform>();
+    return m_prefabs.get(m_prefabs.set(name, std::move(p)));
+}
+
+std::shared_ptr<Entity> Prefabs::spawn(EntityManager& entities, PrefabId id, const Vec2& position) const {
+    if (!id) std::cerr << "[Prefabs] Spawning a missing prefab\n";
+    const Prefab& p = m_prefabs.get(id);
+    auto e = entities.addEntity(p.tag, p.components);
+    place(*e, position, {}, 0);
+    return e;
+}
+
+void Prefabs::spawn(EntityManager& entities, PrefabId id, std::size_t count, const Vec2* positions,
+                    const PrefabOverrides& overrides, EntityVec* out) const {
+    if (!id) std::cerr << "[Prefabs] Spawning " << count << " of a missing prefab\n";
+    const Prefab& p = m_prefabs.get(id);
+
+    entities.reserve(count);
+    if (out) out->reserve(out->size() + count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        auto e = entities.addEntity(p.tag, p.components);
+        place(*e, positions[i], overrides, i);
+        if (out) out->push_back(std::move(e));
+    }
+}
+
+void Prefabs::place(Entity& e, const Vec2& position, const PrefabOverrides& overrides, std::size_t i) {
+    auto& tf = e.getComponent<CTransform>();
+    tf.has = true;
+    tf.pos = tf.prevPos = position;
+    if (overrides.velocities) tf.velocity = overrides.velocities[i];
+    if (overrides.angles)     tf.angle    = overrides.angles[i];
+
+    auto& sh = e.getComponent<CShape>();
+    if (!sh.has || !sh.shape) return;
+    if (overrides.fills) sh.shape->setFillColor(overrides.fills[i]);
+    if (overrides.points) {
+        if (auto c = sh.asCircle()) c->setPointCount(overrides.points[i]);
+    }
+    sh.setPosition(tf.pos);
+    sh.setRotation(tf.angle);
+}
@@ -0,0 +1,101 @@
+#include "../include/RenderFrame.h"
+#include <atomic>
+
+namespace {
+    std::uint64_t nextResourceId()
+    {
+        static std::atomic<std::uint64_t> counter{0};
+        return ++counter;
+    }
+}
+
+std::mutex & glyphMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::uint64_t StaticMesh::nextId()  { return nextResourceId(); }
+std::uint64_t RenderImage::nextId() { return nextResourceId(); }
+
+void RenderFrame::clear()
+{
+    m_vertices.clear();
+    m_commands.clear();
+    m_views.clear();
+    m_meshes.clear();
+    m_texts.clear();
+    m_shapes.clear();
+    m_images.clear();
+    m_clearColor = sf::Color::Black;
+    m_inputTime  = {};
+}
+
+void RenderFrame::setView(const sf::View & view)
+{
+    m_commands.push_back({ Kind::View, sf::PrimitiveType::Triangles, nullptr, sf::BlendAlpha, m_views.size(), 1 });
+    m_views.push_back(view);
+}
+
+void RenderFrame::draw(const sf::Vertex * vertices, std::size_t count, sf::PrimitiveType type,
+                       const sf::Texture * texture, const sf::BlendMode & blend)
+{
+    if (count == 0) return;
+
+    const bool mergeable = type == sf::PrimitiveType::Triangles
+                        || type == sf::PrimitiveType::Lines
+                        || type == sf::PrimitiveType::Points;
+
+    if (mergeable && !m_commands.empty())
+    {
+        auto & last = m_commands.back();
+        if (last.kind == Kind::Vertices && last.primitive == type && last.texture == texture
+            && last.blend == blend && last.first + last.count == m_vertices.size())
+        {
+            m_vertices.insert(m_vertices.end(), vertices, vertices + count);
+            last.count += count;
+            return;
+        }
+    }
+
+    m_commands.push_back({ Kind::Vertices, type, texture, blend, m_vertices.size(), count });
+    m_vertices.insert(m_vertices.end(), vertices, vertices + count);
+}
+
+void RenderFrame::draw(const std::shared_ptr<const StaticMesh> & mesh)
+{
+    if (!mesh || mesh->vertices.empty()) return;
+    m_commands.push_back({ Kind::Mesh, sf::PrimitiveType::Triangles, mesh->texture, sf::BlendAlpha, m_meshes.size(), 1 });
+    m_meshes.push_back(mesh);
+}
+
+void RenderFrame::draw(const sf::Text & text)
+{
+    m_commands.push_back({ Kind::Text, sf::PrimitiveType::Triangles, nullptr, sf::BlendAlpha, m_texts.size(), 1 });
+    m_texts.push_back(text);
+
+    // lay it out now, so drawing it on the render thread finds every glyph already rasterized
+    std::lock_guard<std::mutex> lock(glyphMutex());
+    m_texts.back().getLocalBounds();
+}
+
+void RenderFrame::draw(const sf::Shape & shape)
+{
+    Shape copy;
+    if      (auto c = dynamic_cast<const sf::CircleShape*>(&shape))    copy = *c;
+    else if (auto r = dynamic_cast<const sf::RectangleShape*>(&shape)) copy = *r;
+    else if (auto p = dynamic_cast<const sf::ConvexShape*>(&shape))    copy = *p;
+    else return;
+
+    m_commands.push_back({ Kind::Shape, sf::PrimitiveType::Triangles, nullptr, sf::BlendAlpha, m_shapes.size(), 1 });
+    m_shapes.push_back(std::move(copy));
+}
+
+void RenderFrame::draw(const std::shared_ptr<const RenderImage> & image, const sf::Vertex * quad,
+                       const sf::BlendMode & blend)
+{
+    if (!image || image->pixels.empty()) return;
+    m_commands.push_back({ Kind::Image, sf::PrimitiveType::Triangles, nullptr, blend, m_vertices.size(), 6, m_images.size() });
+    m_vertices.insert(m_vertices.end(), quad, quad + 6);
+    m_images.push_back(image);
+}
@@ -0,0 +1,192 @@
+#include "../include/RenderQueue.h"
+#include <algorithm>
+#include <cmath>
+
+std::uint64_t RenderQueue::makeKey(RenderLayer layer, float depth, std::uint32_t blend, std::uint32_t texture)
+{
+    const float d = std::clamp(depth, 0.f, 1.f);
+    const auto  q = static_cast<std::uint64_t>(d * 65535.f + 0.5f);
+    return (static_cast<std::uint64_t>(layer)      << 56)
+         | (q                                      << 40)
+         | (static_cast<std::uint64_t>(blend & 0xF)       << 36)
+         | (static_cast<std::uint64_t>(texture & 0xFFFFF) << 16);
+}
+
+void RenderQueue::makeQuad(sf::Vertex * v, const sf::IntRect & rect,
+                           const sf::Vector2f & origin, const sf::Vector2f & position,
+                           const sf::Vector2f & scale, float angleDegrees,
+                           const sf::Color & color)
+{
+    // matches sf::Transformable::getTransform() so output is identical to sf::Sprite
+    const float angle = -angleDegrees * 3.14159265f / 180.f;
+    const float cs    = std::cos(angle);
+    const float sn    = std::sin(angle);
+    const float sxc   = scale.x * cs;
+    const float syc   = scale.y * cs;
+    const float sxs   = scale.x * sn;
+    const float sys   = scale.y * sn;
+    const float tx    = -origin.x * sxc - origin.y * sys + position.x;
+    const float ty    =  origin.x * sxs - origin.y * syc + position.y;
+
+    const float w = static_cast<float>(std::abs(rect.size.x));
+    const float h = static_cast<float>(std::abs(rect.size.y));
+
+    auto corner = [&](float x, float y) {
+        return sf::Vector2f{ sxc * x + sys * y + tx, -sxs * x + syc * y + ty };
+    };
+
+    const sf::Vector2f p0 = corner(0.f, 0.f);
+    const sf::Vector2f p1 = corner(w,   0.f);
+    const sf::Vector2f p2 = corner(0.f, h);
+    const sf::Vector2f p3 = corner(w,   h);
+
+    const float left   = static_cast<float>(rect.position.x);
+    const float top    = static_cast<float>(rect.position.y);
+    const float right  = left + static_cast<float>(rect.size.x);
+    const float bottom = top  + static_cast<float>(rect.size.y);
+
+    v[0] = { p0, color, { left,  top    } };
+    v[1] = { p1, color, { right, top    } };
+    v[2] = { p2, color, { left,  bottom } };
+    v[3] = { p2, color, { left,  bottom } };
+    v[4] = { p1, color, { right, top    } };
+    v[5] = { p3, color, { right, bottom } };
+}
+
+std::uint32_t RenderQueue::textureId(const sf::Texture * texture)
+{
+    if (!texture) return 0;
+    auto [it, added] = m_textureIds.try_emplace(texture, static_cast<std::uint32_t>(m_textureIds.size() + 1));
+    return it->second;
+}
+
+std::uint32_t RenderQueue::blendId(const sf::BlendMode & blend)
+{
+    auto it = std::find(m_blendModes.begin(), m_blendModes.end(), blend);
+    if (it != m_blendModes.end()) return static_cast<std::uint32_t>(it - m_blendModes.begin());
+    m_blendModes.push_back(blend);
+    return static_cast<std::uint32_t>(m_blendModes.size() - 1);
+}
+
+void RenderQueue::push(Item item, RenderLayer layer, float depth)
+{
+    item.key = makeKey(layer, depth, item.blend, textureId(item.texture));
+    m_items.push_back(item);
+}
+
+void RenderQueue::drawSprite(RenderLayer layer, float depth, const sf::Texture & texture,
+                             const sf::IntRect & rect, const sf::Vector2f & origin,
+                             const sf::Vector2f & position, const sf::Vector2f & scale,
+                             float angleDegrees, const sf::Color & color,
+                             const sf::BlendMode & blend)
+{
+    const auto first = static_cast<std::uint32_t>(m_vertices.size());
+    m_vertices.resize(m_vertices.size() + 6);
+    makeQuad(&m_vertices[first], rect, origin, position, scale, angleDegrees, color);
+    push({ 0, Kind::Vertices, sf::PrimitiveType::Triangles, &texture, blendId(blend), first, 6 }, layer, depth);
+}
+
+void RenderQueue::draw(RenderLayer layer, float depth, const sf::Vertex * vertices, std::size_t count,
+                       sf::PrimitiveType type, const sf::Texture * texture, const sf::BlendMode & blend)
+{
+    if (count == 0) return;
+    const auto first = static_cast<std::uint32_t>(m_vertices.size());
+    m_vertices.insert(m_vertices.end(), vertices, vertices + count);
+    push({ 0, Kind::Vertices, type, texture, blendId(blend), first, static_cast<std::uint32_t>(count) }, layer, depth);
+}
+
+void RenderQueue::draw(RenderLayer layer, float depth, const std::shared_ptr<const StaticMesh> & mesh)
+{
+    if (!mesh || mesh->vertices.empty()) return;
+    push({ 0, Kind::Mesh, sf::PrimitiveType::Triangles, mesh->texture, 0,
+           static_cast<std::uint32_t>(m_meshes.size()), 1 }, layer, depth);
+    m_meshes.push_back(mesh);
+}
+
+void RenderQueue::draw(RenderLayer layer, float depth, const sf::Text & text)
+{
+    // getTexture creates the font page if this size is new
+    const sf::Texture * texture = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(glyphMutex());
+        texture = &text.getFont().getTexture(text.getCharacterSize());
+    }
+    push({ 0, Kind::Text, sf::PrimitiveType::Triangles, texture, 0,
+           static_cast<std::uint32_t>(m_texts.size()), 1 }, layer, depth);
+    m_texts.push_back(&text);
+}
+
+void RenderQueue::draw(RenderLayer layer, float depth, const sf::Shape & shape)
+{
+    push({ 0, Kind::Shape, sf::PrimitiveType::Triangles, shape.getTexture(), 0,
+           static_cast<std::uint32_t>(m_shapes.size()), 1 }, layer, depth);
+    m_shapes.push_back(&shape);
+}
+
+// LSD radix sort on the key, 8 bits per pass; passes where every key has the
+// same byte are skipped, so in practice only the layer/depth/texture bytes cost anything
+void RenderQueue::sort()
+{
+    const std::size_t n = m_items.size();
+    m_sorted.resize(n);
+    m_scratch.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+        m_sorted[i] = { m_items[i].key, static_cast<std::uint32_t>(i) };
+
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        std::size_t counts[256] = {};
+        for (const auto & e : m_sorted) ++counts[(e.key >> shift) & 0xFF];
+        if (counts[(m_sorted[0].key >> shift) & 0xFF] == n) continue;
+
+        std::size_t offset = 0;
+        for (auto & c : counts) { const std::size_t k = c; c = offset; offset += k; }
+        for (const auto & e : m_sorted) m_scratch[counts[(e.key >> shift) & 0xFF]++] = e;
+        m_sorted.swap(m_scratch);
+    }
+}
+
+void RenderQueue::flush(RenderFrame & frame)
+{
+    m_batches = 0;
+    if (m_items.empty()) return;
+
+    sort();
+
+    const Item * prev = nullptr;
+    for (const auto & e : m_sorted)
+    {
+        const Item & it = m_items[e.item];
+        const bool sameState = prev && prev->kind == Kind::Vertices && it.kind == Kind::Vertices
+                            && prev->texture == it.texture && prev->blend == it.blend
+                            && prev->primitive == it.primitive;
+        if (!sameState) ++m_batches;
+        prev = &it;
+
+        switch (it.kind)
+        {
+        case Kind::Vertices:
+            frame.draw(&m_vertices[it.first], it.count, it.primitive, it.texture, m_blendModes[it.blend]);
+            break;
+        case Kind::Mesh:
+            frame.draw(m_meshes[it.first]);
+            break;
+        case Kind::Text:
+            frame.draw(*m_texts[it.first]);
+            break;
+        case Kind::Shape:
+            frame.draw(*m_shapes[it.first]);
+            break;
+        }
+    }
+    clear();
+}
+
+void RenderQueue::clear()
+{
+    m_items.clear();
+    m_vertices.clear();
+    m_meshes.clear();
+    m_texts.clear();
+    m_shapes.clear();
+}
@@ -0,0 +1,237 @@
+#include "../include/Renderer.h"
+#include <cstring>
+#include <iostream>
+
+namespace {
+    // GPU copies of meshes that have not been drawn for this many frames are dropped
+    constexpr std::size_t MESH_EVICT_FRAMES = 600;
+}
+
+Renderer::Renderer(sf::RenderWindow & window)
+: m_window(window)
+{
+}
+
+Renderer::~Renderer()
+{
+    stop();
+}
+
+void Renderer::start(bool threaded)
+{
+    stop();
+    m_threaded = threaded;
+    m_back     = 0;
+    m_frames[0].clear();
+    m_frames[1].clear();
+    if (!m_threaded) return;
+
+    // a GL context can only be current on one thread at a time
+    if (!m_window.setActive(false))
+        std::cerr << "[Renderer] Could not release the window context\n";
+
+    m_pending.store(NO_FRAME);
+    m_thread = std::thread(&Renderer::threadMain, this);
+}
+
+void Renderer::stop()
+{
+    if (!m_thread.joinable()) return;
+
+    m_pending.store(STOP, std::memory_order_release);
+    m_pending.notify_all();
+    m_thread.join();
+
+    if (!m_window.setActive(true))
+        std::cerr << "[Renderer] Could not reacquire the window context\n";
+    m_threaded = false;
+}
+
+RenderFrame & Renderer::frame()
+{
+    return m_frames[m_back];
+}
+
+void Renderer::submit()
+{
+    RenderFrame & f = m_frames[m_back];
+    f.setNumber(m_frameNumber++);
+
+    if (!m_threaded)
+    {
+        present(f);
+        f.clear();
+        return;
+    }
+
+    // publish, then wait until the render thread has taken it; once it has,
+    // it is no longer reading the other buffer and we may record into it
+    m_pending.store(m_back, std::memory_order_release);
+    m_pending.notify_one();
+    for (int p = m_pending.load(std::memory_order_acquire); p == m_back;
+         p = m_pending.load(std::memory_order_acquire))
+        m_pending.wait(p, std::memory_order_acquire);
+
+    m_back ^= 1;
+    m_frames[m_back].clear();
+}
+
+void Renderer::threadMain()
+{
+    if (!m_window.setActive(true))
+    {
+        std::cerr << "[Renderer] Render thread could not activate the window context\n";
+        return;
+    }
+
+    for (;;)
+    {
+        m_pending.wait(NO_FRAME, std::memory_order_acquire);
+        const int index = m_pending.load(std::memory_order_acquire);
+        if (index == STOP) break;
+        if (index == NO_FRAME) continue;
+
+        // take the frame and release the simulation before drawing
+        int expected = index;
+        if (!m_pending.compare_exchange_strong(expected, NO_FRAME, std::memory_order_acq_rel)) continue;
+        m_pending.notify_one();
+
+        present(m_frames[index]);
+    }
+
+    if (!m_window.setActive(false))
+        std::cerr << "[Renderer] Render thread could not release the window context\n";
+}
+
+void Renderer::present(const RenderFrame & frame)
+{
+    m_window.clear(frame.clearColor());
+    {
+        std::lock_guard<std::mutex> lock(glyphMutex());
+        execute(frame);
+    }
+    m_capture.onFrame(m_window);
+    m_window.display();
+    m_framesDrawn.fetch_add(1, std::memory_order_relaxed);
+
+    if (frame.inputTime() != std::chrono::steady_clock::time_point{})
+    {
+        const auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame.inputTime());
+        std::lock_guard<std::mutex> lock(m_latencyMutex);
+        m_latency.add(ms.count());
+    }
+}
+
+void Renderer::execute(const RenderFrame & frame)
+{
+    ++m_executed;
+    std::size_t calls = 0;
+
+    for (const auto & cmd : frame.commands())
+    {
+        sf::RenderStates states;
+        states.texture   = cmd.texture;
+        states.blendMode = cmd.blend;
+
+        switch (cmd.kind)
+        {
+        case RenderFrame::Kind::View:
+            m_window.setView(frame.views()[cmd.first]);
+            break;
+        case RenderFrame::Kind::Vertices:
+            m_window.draw(&frame.vertices()[cmd.first], cmd.count, cmd.primitive, states);
+            ++calls;
+            break;
+        case RenderFrame::Kind::Mesh:
+            drawMesh(*frame.meshes()[cmd.first], states, calls);
+            break;
+        case RenderFrame::Kind::Text:
+            m_window.draw(frame.texts()[cmd.first]);
+            ++calls;
+            break;
+        case RenderFrame::Kind::Shape:
+            std::visit([&](const auto & s) { m_window.draw(s); }, frame.shapes()[cmd.first]);
+            ++calls;
+            break;
+        case RenderFrame::Kind::Image:
+            states.texture = imageTexture(*frame.images()[cmd.resource]);
+            if (!states.texture) break;
+            m_window.draw(&frame.vertices()[cmd.first], cmd.count, cmd.primitive, states);
+            ++calls;
+            break;
+        }
+    }
+    m_drawCalls.store(calls, std::memory_order_relaxed);
+
+    // drop GPU copies of meshes that are gone or long off-screen
+    if (m_executed % 60 == 0)
+    {
+        for (auto it = m_meshBuffers.begin(); it != m_meshBuffers.end();)
+        {
+            if (m_executed - it->second.lastUsed > MESH_EVICT_FRAMES) it = m_meshBuffers.erase(it);
+            else ++it;
+        }
+        for (auto it = m_imageTextures.begin(); it != m_imageTextures.end();)
+        {
+            if (m_executed - it->second.lastUsed > MESH_EVICT_FRAMES) it = m_imageTextures.erase(it);
+            else ++it;
+        }
+    }
+}
+
+const sf::Texture * Renderer::imageTexture(const RenderImage & image)
+{
+    ImageTexture & it = m_imageTextures[image.slot];
+    it.lastUsed = m_executed;
+    if (it.valid && it.version == image.version) return &it.texture;
+
+    if (it.valid && it.version == image.base && !image.dirty.empty() && it.texture.getSize() == image.size)
+    {
+        // only what changed since the version we hold
+        for (const auto & r : image.dirty)
+        {
+            const auto row = static_cast<std::size_t>(r.size.x) * 4;
+            m_uploadScratch.resize(row * static_cast<std::size_t>(r.size.y));
+            for (int y = 0; y < r.size.y; ++y)
+                std::memcpy(&m_uploadScratch[y * row],
+                            &image.pixels[((static_cast<std::size_t>(r.position.y) + y) * image.size.x + r.position.x) * 4], row);
+            it.texture.update(m_uploadScratch.data(), sf::Vector2u(r.size), sf::Vector2u(r.position));
+        }
+        it.version = image.version;
+        return &it.texture;
+    }
+
+    if (it.texture.getSize() != image.size && !it.texture.resize(image.size))
+    {
+        it.valid = false;
+        return nullptr;
+    }
+    it.texture.update(image.pixels.data());
+    it.texture.setSmooth(image.smooth);
+    it.texture.setRepeated(image.repeated);
+    it.version = image.version;
+    it.valid   = true;
+    return &it.texture;
+}
+
+void Renderer::drawMesh(const StaticMesh & mesh, const sf::RenderStates & states, std::size_t & calls)
+{
+    ++calls;
+    if (!sf::VertexBuffer::isAvailable())
+    {
+        m_window.draw(mesh.vertices.data(), mesh.vertices.size(), sf::PrimitiveType::Triangles, states);
+        return;
+    }
+
+    auto [it, added] = m_meshBuffers.try_emplace(mesh.id);
+    MeshBuffer & mb = it->second;
+    mb.lastUsed = m_executed;
+    if (added)
+    {
+        mb.uploaded = mb.buffer.create(mesh.vertices.size())
+                   && mb.buffer.update(mesh.vertices.data());
+    }
+
+    if (mb.uploaded) m_window.draw(mb.buffer, states);
+    else             m_window.draw(mesh.vertices.data(), mesh.vertices.size(), sf::PrimitiveType::Triangles, states);
+}
@@ -0,0 +1,212 @@
+#include "../include/RoomServer.h"
+#include "../include/Scene_Play.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+namespace {
+    constexpr std::uint64_t REBALANCE_TICKS = 60;     // about once a second at 60Hz
+    constexpr double        LOAD_SMOOTHING  = 1.0 / 16.0;
+    constexpr double        MIN_GAIN_MS     = 0.05;   // moves that gain less are not worth the churn
+
+    double ms(RoomServer::Clock::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+}
+
+RoomServer::RoomServer(const std::string & configPath, const RoomServerConfig & config)
+    : m_config(config)
+    , m_engine(configPath, /*headless=*/true)
+    , m_worldIo(std::make_unique<ThreadPool>(1))
+{
+    m_engine.assets().finishLoad();
+
+    const std::size_t lanes = m_config.lanes ? m_config.lanes : std::max(1u, std::thread::hardware_concurrency());
+    m_lanes.resize(lanes);
+    if (lanes > 1) m_pool = std::make_unique<ThreadPool>(lanes - 1);
+    m_pacer.setTargetFps(m_config.tickRate);
+}
+
+RoomServer::~RoomServer()
+{
+    for (auto & lane : m_lanes)
+        for (auto & room : lane.rooms) room->scene->onEnd();
+}
+
+// least load, then fewest rooms: before the first tick every room costs 0
+std::size_t RoomServer::quietestLane() const
+{
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < m_lanes.size(); ++i) {
+        const Lane & a = m_lanes[i];
+        const Lane & b = m_lanes[best];
+        if (a.load < b.load || (a.load == b.load && a.rooms.size() < b.rooms.size())) best = i;
+    }
+    return best;
+}
+
+RoomServer::RoomId RoomServer::addRoom(const std::string & levelPath, double budgetMs)
+{
+    auto room = std::make_unique<Room>();
+    room->id       = m_nextId++;
+    room->budgetMs = budgetMs > 0.0 ? budgetMs : m_config.budgetMs;
+    room->scene    = std::make_unique<Scene_Play>(&m_engine, levelPath,
+                                                  levelPath + ".room" + std::to_string(room->id) + ".world",
+                                                  m_worldIo.get());
+
+    // load and init both here: init binds actions and defines sounds, which are not thread safe
+    room->scene->load();
+    room->scene->init();
+
+    // until it has been measured, a room is assumed to cost what the average room does
+    double total = 0.0;
+    for (const auto & [id, r] : m_rooms) total += r->stats.load;
+    room->stats.load = m_rooms.empty() ? 0.0 : total / m_rooms.size();
+
+    room->lane = quietestLane();
+    Lane & lane = m_lanes[room->lane];
+    lane.load += room->stats.load;
+
+    const RoomId id = room->id;
+    m_rooms.emplace(id, room.get());
+    lane.rooms.push_back(std::move(room));
+    return id;
+}
+
+void RoomServer::removeRoom(RoomId id)
+{
+    auto it = m_rooms.find(id);
+    if (it == m_rooms.end()) return;
+
+    Lane & lane = m_lanes[it->second->lane];
+    auto pos = std::find_if(lane.rooms.begin(), lane.rooms.end(), [&](const auto & r) { return r->id == id; });
+    (*pos)->scene->onEnd();
+    lane.load -= (*pos)->stats.load;
+    lane.rooms.erase(pos);
+    m_rooms.erase(it);
+}
+
+void RoomServer::doAction(RoomId id, const Action & action)
+{
+    if (auto it = m_rooms.find(id); it != m_rooms.end()) it->second->actions.push_back(action);
+    else std::cerr << "[Server] No room " << id << " for action '" << action.name() << "'\n";
+}
+
+const RoomServer::RoomStats * RoomServer::roomStats(RoomId id) const
+{
+    auto it = m_rooms.find(id);
+    return it == m_rooms.end() ? nullptr : &it->second->stats;
+}
+
+// runs on the lane's thread; touches only the lane and its rooms
+void RoomServer::tickLane(Lane & lane)
+{
+    lane.load = 0.0;
+    for (auto & room : lane.rooms) {
+        const auto start = Clock::now();
+        for (const Action & a : room->actions) room->scene->doAction(a);
+        room->actions.clear();
+        room->scene->simulate(1);
+        const double t = ms(Clock::now() - start);
+
+        RoomStats & s = room->stats;
+        s.tickTime.add(t);
+        ++s.ticks;
+        s.load = s.ticks == 1 ? t : s.load + (t - s.load) * LOAD_SMOOTHING;
+        if (t > room->budgetMs) { ++s.overruns; ++lane.overruns; }
+        lane.load += s.load;
+    }
+}
+
+void RoomServer::tick()
+{
+    const auto start = Clock::now();
+
+    // the calling thread takes the last lane instead of waiting idle
+    m_pending.clear();
+    for (std::size_t i = 0; i + 1 < m_lanes.size(); ++i)
+        if (!m_lanes[i].rooms.empty()) m_pending.push_back(m_pool->submit([this, i] { tickLane(m_lanes[i]); }));
+    tickLane(m_lanes.back());
+    for (auto & f : m_pending) f.get();
+
+    const double t = ms(Clock::now() - start);
+    m_stats.tickTime.add(t);
+    ++m_stats.ticks;
+    if (m_config.tickRate && t > 1000.0 / m_config.tickRate) ++m_stats.late;
+    for (auto & lane : m_lanes) {
+        m_stats.overruns += lane.overruns;
+        lane.overruns = 0;
+    }
+
+    // rooms that ended themselves are dropped between ticks
+    std::vector<RoomId> ended;
+    for (const auto & [id, room] : m_rooms)
+        if (room->scene->hasEnded()) ended.push_back(id);
+    for (RoomId id : ended) removeRoom(id);
+
+    if (m_stats.ticks % REBALANCE_TICKS == 0) rebalance();
+}
+
+// moves at most one room per call, so a noisy measurement cannot reshuffle everything
+void RoomServer::rebalance()
+{
+    if (m_lanes.size() < 2) return;
+
+    std::size_t busiest = 0;
+    for (std::size_t i = 1; i < m_lanes.size(); ++i)
+        if (m_lanes[i].load > m_lanes[busiest].load) busiest = i;
+    const std::size_t quietest = quietestLane();
+    Lane & from = m_lanes[busiest];
+    Lane & to   = m_lanes[quietest];
+
+    // the room that leaves the lower of the two lanes' new peaks
+    auto best = from.rooms.end();
+    double bestPeak = from.load - MIN_GAIN_MS;
+    for (auto it = from.rooms.begin(); it != from.rooms.end(); ++it) {
+        const double l = (*it)->stats.load;
+        const double peak = std::max(from.load - l, to.load + l);
+        if (peak < bestPeak) { bestPeak = peak; best = it; }
+    }
+    if (best == from.rooms.end()) return;
+
+    auto room = std::move(*best);
+    from.rooms.erase(best);
+    from.load -= room->stats.load;
+    to.load   += room->stats.load;
+    room->lane = quietest;
+    to.rooms.push_back(std::move(room));
+    ++m_stats.migrations;
+}
+
+void RoomServer::run(std::uint64_t ticks)
+{
+    m_running = true;
+    for (std::uint64_t i = 0; m_running && (ticks == 0 || i < ticks); ++i) {
+        m_pacer.wait();
+        tick();
+    }
+}
+
+double RoomServer::roomsPerCore() const
+{
+    if (!m_config.tickRate || m_rooms.empty()) return 0.0;
+    double total = 0.0;
+    for (const auto & [id, room] : m_rooms) total += room->stats.load;
+    const double mean = total / m_rooms.size();
+    return mean > 0.0 ? (1000.0 / m_config.tickRate) / mean : 0.0;
+}
+
+void RoomServer::printStats() const
+{
+    std::size_t most = 0;
+    for (const auto & lane : m_lanes) most = std::max(most, lane.rooms.size());
+
+    const auto & t = m_stats.tickTime;
+    std::cout << "[Server] " << m_rooms.size() << " rooms on " << m_lanes.size() << " lanes (at most " << most
+              << " per lane), " << m_config.tickRate << " Hz; tick p50 " << t.percentile(0.5) << " p99 "
+              << t.percentile(0.99) << " max " << t.max() << " ms, " << m_stats.late << "/" << m_stats.ticks
+              << " late, " << m_stats.overruns << " room overruns, " << m_stats.migrations << " migrations, "
+              << m_pacer.stats().missed << " missed; capacity " << roomsPerCore() << " rooms per core\n";
+}
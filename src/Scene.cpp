@@ -4,20 +4,36 @@
 
 Scene::Scene(GameEngine* g) : m_game(g) {}
 
-void Scene::registerAction(int inputKey, const std::string& actionName) {
-    m_actionMap[inputKey] = actionName;
+// names are interned here, once; the engine then maps keys straight to ids
+ActionId Scene::registerAction(int inputKey, const std::string& actionName) {
+    const ActionId id = Action::intern(actionName);
+    m_actionMap.set(inputKey, id);
+    return id;
+}
+
+void Scene::onAction(const std::string& actionName, ActionHandler handler) {
+    const ActionId id = Action::intern(actionName);
+    if (id >= m_actionHandlers.size()) m_actionHandlers.resize(id + 1u);
+    m_actionHandlers[id] = std::move(handler);
 }
 
 const ActionMap& Scene::getActionMap() const { return m_actionMap; }
 
 void Scene::setPaused(bool p) { m_paused = p; }
 
-size_t Scene::width()  const { return static_cast<int>(m_game->window().getSize().x); }
-size_t  Scene::height() const { return static_cast<int>(m_game->window().getSize().y); }
+size_t Scene::width()  const { return m_game->size().x; }
+size_t Scene::height() const { return m_game->size().y; }
+size_t Scene::currentFrame() const { return m_currentFrame; }
+bool Scene::hasEnded() const { return m_hasEnded; }
+
+void Scene::simulate(const size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        update();
+        ++m_currentFrame;
+    }
+}
 
+// queued on the debug layer; drawn when the scene flushes m_debugDraw
 void Scene::drawLine(const Vec2& p1, const Vec2& p2) {
-    sf::Vertex verts[2];
-    verts[0].position = sf::Vector2f(p1.x, p1.y);
-    verts[1].position = sf::Vector2f(p2.x, p2.y);
-    m_game->window().draw(verts, 2, sf::PrimitiveType::Lines);
+    m_debugDraw.line(p1, p2);
 }
@@ -2,58 +2,95 @@
 #include "../include/GameEngine.h"
 #include "../include/Scene_Play.h"
 #include <SFML/Window/Keyboard.hpp>
+#include <charconv>
 
 Scene_Menu::Scene_Menu(GameEngine* g)
-: Scene(g)
-, m_menuText(g->assets().getFont("Tech"), "", 24) {}
+: Scene(g) {}
 
 void Scene_Menu::init() {
     m_title = "COMP4300 Demo";
     m_menuStrings = {"Play", "Quit"};
     m_levelPaths  = {"../levels/level1.txt", ""};
+    m_preloaded.assign(m_menuStrings.size(), false);
 
     registerAction(static_cast<int>(sf::Keyboard::Scancode::Up),           "UP");
     registerAction(static_cast<int>(sf::Keyboard::Scancode::Down),         "DOWN");
     registerAction(static_cast<int>(sf::Keyboard::Scancode::Enter),        "SELECT");
     registerAction(static_cast<int>(sf::Keyboard::Scancode::NumpadEnter),  "SELECT");
     registerAction(static_cast<int>(sf::Keyboard::Scancode::Escape),       "QUIT");
+
+    onAction("UP", [this](const Action& a) {
+        if (a.isStart() && m_selectMenuIndex > 0) hover(m_selectMenuIndex - 1);
+    });
+    onAction("DOWN", [this](const Action& a) {
+        if (a.isStart() && m_selectMenuIndex + 1 < m_menuStrings.size()) hover(m_selectMenuIndex + 1);
+    });
+    onAction("SELECT", [this](const Action& a) { if (a.isStart()) select(); });
+    onAction("QUIT",   [this](const Action& a) { if (a.isStart()) m_game->quit(); });
+
+    // labels are laid out once here; sRender only updates what changed
+    const sf::Font& font = m_game->assets().getFont("Tech");
+    m_text.clear();
+    m_menuLabels.clear();
+    m_titleLabel = m_text.add(font, 32, m_title, Vec2{40.f, 40.f});
+    float y = 120.f;
+    for (const auto& s : m_menuStrings) {
+        m_menuLabels.push_back(m_text.add(font, 24, s, Vec2{60.f, y}));
+        y += 36.f;
+    }
+    m_loadingLabel = m_text.add(font, 16, "", Vec2{60.f, y + 12.f}, sf::Color(160, 160, 160));
+
+    hover(m_selectMenuIndex);
+}
+
+void Scene_Menu::hover(std::size_t item) {
+    m_selectMenuIndex = item;
+    // the highlighted level loads in the background, so choosing it is instant;
+    // headless there is nobody to wait for, so it loads only once chosen
+    if (!m_game->headless()) preload(item);
+}
+
+void Scene_Menu::preload(std::size_t item) {
+    if (m_levelPaths[item].empty() || m_preloaded[item]) return;
+    m_preloaded[item] = true;
+    m_game->preloadScene("PLAY", std::make_shared<Scene_Play>(m_game, m_levelPaths[item]));
 }
 
 void Scene_Menu::update() {}
 
 void Scene_Menu::sRender() {
-    auto& win = m_game->window();
+    auto& frame = m_game->renderFrame();
+    const sf::Vector2f size(m_game->size());
+    frame.setView(sf::View(sf::FloatRect({0.f, 0.f}, size)));
 
-    // title
-    sf::Text title(m_game->assets().getFont("Tech"), m_title, 32);
-    title.setPosition({40.f, 40.f});
-    win.draw(title);
+    // only the selection changes from frame to frame; unchanged styles are no-ops
+    for (std::size_t i = 0; i < m_menuLabels.size(); ++i)
+        m_text.setStyle(m_menuLabels[i], i == m_selectMenuIndex ? sf::Text::Style::Bold
+                                                                : sf::Text::Style::Regular);
 
-    // options
-    float y = 120.f;
-    for (std::size_t i = 0; i < m_menuStrings.size(); ++i) {
-        m_menuText.setString(m_menuStrings[i]);
-        m_menuText.setCharacterSize(24);
-        m_menuText.setPosition({60.f, y});
-        if (i == m_selectMenuIndex) m_menuText.setStyle(sf::Text::Style::Bold);
-        else                        m_menuText.setStyle(sf::Text::Style::Regular);
-        win.draw(m_menuText);
-        y += 36.f;
+    // assets still streaming in: show how far along they are; then the level preload
+    const bool loading = !m_game->assets().loaded();
+    m_text.setVisible(m_loadingLabel, loading || (m_preloaded[PLAY] && !m_game->sceneReady("PLAY")));
+    if (!loading) {
+        m_text.setString(m_loadingLabel, "Loading level");
+    } else {
+        char label[32] = "Loading ";
+        char* p = label + 8;
+        p = std::to_chars(p, label + sizeof(label) - 1,
+                          static_cast<int>(m_game->assets().loadProgress() * 100.f)).ptr;
+        *p++ = '%';
+        m_text.setString(m_loadingLabel, std::string_view(label, static_cast<std::size_t>(p - label)));
     }
+    m_text.draw(frame);
 }
 
-void Scene_Menu::sDoAction(const Action& a) {
-    if (a.isStart()) {
-        if (a.name() == "UP"    && m_selectMenuIndex > 0)                    --m_selectMenuIndex;
-        if (a.name() == "DOWN"  && m_selectMenuIndex + 1 < m_menuStrings.size()) ++m_selectMenuIndex;
-        if (a.name() == "SELECT") {
-            if (m_menuStrings[m_selectMenuIndex] == "Play") {
-                m_game->changeScene("PLAY", std::make_shared<Scene_Play>(m_game, m_levelPaths[0]), true);
-            } else if (m_menuStrings[m_selectMenuIndex] == "Quit") {
-                m_game->quit();
-            }
-        }
-        if (a.name() == "QUIT") m_game->quit();
+void Scene_Menu::select() {
+    if (m_selectMenuIndex == PLAY) {
+        // swaps in as soon as the preload is done; the menu keeps running until then
+        preload(PLAY);
+        m_game->changeScene("PLAY", true);
+    } else if (m_selectMenuIndex == QUIT) {
+        m_game->quit();
     }
 }
 
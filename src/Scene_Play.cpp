@@ -5,18 +5,116 @@
 #include "../include/Components.h"
 #include "../include/Action.h"
 
+#include <algorithm>
+#include <charconv>
 #include <iostream>
-#include <fstream>
+#include <unordered_map>
 
-Scene_Play::Scene_Play(GameEngine * gameEngine, const std::string & levelPath)
+namespace {
+    // tiles and decorations never move, so they live in the spatial index;
+    // everything else is few enough to cull directly every frame
+    bool isStaticTag(const std::string& tag)
+    {
+        return tag == "tile" || tag == "dec";
+    }
+
+    sf::FloatRect transformedBounds(const sf::FloatRect& local, const sf::Vector2f& origin,
+                                    const CTransform& tf)
+    {
+        float x0 = (local.position.x - origin.x) * tf.scale.x;
+        float x1 = (local.position.x + local.size.x - origin.x) * tf.scale.x;
+        float y0 = (local.position.y - origin.y) * tf.scale.y;
+        float y1 = (local.position.y + local.size.y - origin.y) * tf.scale.y;
+        if (x0 > x1) std::swap(x0, x1);
+        if (y0 > y1) std::swap(y0, y1);
+
+        if (tf.angle != 0.f) {
+            // rotated: use the circle around the pivot that contains every corner
+            const float r = std::sqrt(std::max(x0 * x0, x1 * x1) + std::max(y0 * y0, y1 * y1));
+            x0 = y0 = -r;
+            x1 = y1 =  r;
+        }
+        return { {tf.pos.x + x0, tf.pos.y + y0}, {x1 - x0, y1 - y0} };
+    }
+
+    // world streaming granularity, in grid cells
+    constexpr int STREAM_CHUNK_CELLS = 16;
+
+    // fixed logical step of one simulated frame, whether or not the loop is paced
+    constexpr float SIM_DT = GameEngine::FRAME_DT;
+
+    sf::FloatRect renderBounds(const Entity& e, const Assets& assets)
+    {
+        const auto& tf = e.getComponent<CTransform>();
+        const auto& ca = e.getComponent<CAnimation>();
+        const auto& sh = e.getComponent<CShape>();
+
+        if (ca.has) {
+            const auto& clip = assets.getAnimation(ca.clip);
+            const auto  r    = ca.rect(clip);
+            const sf::FloatRect local{ {0.f, 0.f},
+                { static_cast<float>(std::abs(r.size.x)), static_cast<float>(std::abs(r.size.y)) } };
+            return transformedBounds(local, clip.origin, tf);
+        }
+        if (sh.has && sh.shape) {
+            return transformedBounds(sh.shape->getLocalBounds(), sh.shape->getOrigin(), tf);
+        }
+        if (e.hasComponent<CBoundingBox>()) {
+            const auto& bb = e.getComponent<CBoundingBox>();
+            return { {tf.pos.x + bb.offset.x - bb.halfSize.x, tf.pos.y + bb.offset.y - bb.halfSize.y},
+                     {bb.size.x, bb.size.y} };
+        }
+        return { {tf.pos.x, tf.pos.y}, {0.f, 0.f} };
+    }
+
+    bool overlaps(const sf::FloatRect& a, const sf::FloatRect& b)
+    {
+        return a.position.x < b.position.x + b.size.x && b.position.x < a.position.x + a.size.x
+            && a.position.y < b.position.y + b.size.y && b.position.y < a.position.y + a.size.y;
+    }
+}
+
+Scene_Play::Scene_Play(GameEngine * gameEngine, const std::string & levelPath, const std::string & worldDir,
+                       ThreadPool * worldIo)
     : Scene(gameEngine)
     , m_levelPath(levelPath)
+    , m_worldDir(worldDir.empty() ? levelPath + ".world" : worldDir)
+    , m_worldIo(worldIo)
     , m_gridText(gameEngine->assets().getFont("Tech"),"", 12)
+    , m_tileLayer(m_gridSize)
+    , m_lightMap(m_gridSize)
 {
+    m_lightMap.setAmbient(sf::Color(72, 72, 96));
+}
+
+// may run on the scene loader thread: only reads asset tables, and only
+// touches this scene's own entities and world files
+void Scene_Play::load()
+{
+    // resolve names once; spawning and per-frame code only index by id
+    const Assets& assets = m_game->assets();
+    m_anims.idle        = assets.getAnimationId("Idle");
+    m_anims.stand       = assets.getAnimationId("Stand");
+    m_anims.brick       = assets.findAnimationId("Brick");
+    m_anims.blocksSheet = assets.getAnimationId("BlocksSheet");
+    m_anims.air         = assets.findAnimationId("Air");
+    m_anims.run         = assets.findAnimationId("Run");
+
+    // optional: the level plays without it if the config has no such sound
+    m_breakSound   = assets.findSoundId("BrickBreak");
+    m_bulletPrefab = m_game->prefabs().find("Bullet");
+
+    m_levelLoaded = loadLevel(m_levelPath);
 }
 
 void Scene_Play::init()
 {
+    Assets& assets = m_game->assets();
+    m_game->audio().define(m_breakSound, { /*priority=*/1, /*maxInstances=*/3 });
+
+    // start streaming in what the level spawns with before the first frame needs it
+    for (AnimId id : { m_anims.idle, m_anims.stand, m_anims.blocksSheet, m_anims.air, m_anims.run })
+        assets.prefetch(id);
 
     registerAction(static_cast<int>(sf::Keyboard::Scancode::W),      "UP");
     registerAction(static_cast<int>(sf::Keyboard::Scancode::Up),     "UP");
@@ -26,16 +124,36 @@ void Scene_Play::init()
     registerAction(static_cast<int>(sf::Keyboard::Scancode::Left),   "LEFT");
     registerAction(static_cast<int>(sf::Keyboard::Scancode::D),      "RIGHT");
     registerAction(static_cast<int>(sf::Keyboard::Scancode::Right),  "RIGHT");
+    registerAction(static_cast<int>(sf::Keyboard::Scancode::Space),  "SHOOT");
 
     registerAction(static_cast<int>(sf::Keyboard::Scancode::P),      "PAUSE");
     registerAction(static_cast<int>(sf::Keyboard::Scancode::Escape), "QUIT");
     registerAction(static_cast<int>(sf::Keyboard::Scancode::T),      "TOGGLE_TEXTURE");
     registerAction(static_cast<int>(sf::Keyboard::Scancode::C),      "TOGGLE_COLLISION");
     registerAction(static_cast<int>(sf::Keyboard::Scancode::G),      "TOGGLE_GRID");
+    registerAction(static_cast<int>(sf::Keyboard::Scancode::L),      "TOGGLE_LIGHTING");
+
+    // movement follows the key state; toggles flip on press
+    const auto input = [this](bool CInput::* flag) {
+        return [this, flag](const Action& a) { if (m_player) m_player->getComponent<CInput>().*flag = a.isStart(); };
+    };
+    const auto toggle = [](bool& flag) {
+        return [&flag](const Action& a) { if (a.isStart()) flag = !flag; };
+    };
+    onAction("UP",               input(&CInput::up));
+    onAction("DOWN",             input(&CInput::down));
+    onAction("LEFT",             input(&CInput::left));
+    onAction("RIGHT",            input(&CInput::right));
+    onAction("SHOOT",            [this](const Action& a) { if (a.isStart() && m_player) spawnBullet(m_player); });
+    onAction("TOGGLE_TEXTURE",   toggle(m_drawTextures));
+    onAction("TOGGLE_COLLISION", toggle(m_drawCollision));
+    onAction("TOGGLE_GRID",      toggle(m_drawGrid));
+    onAction("TOGGLE_LIGHTING",  toggle(m_drawLighting));
 
+    m_gridText.setCharacterSize(12);
+    m_gridText.setFont(m_game->assets().getFont("Tech"));
 
-    std::ifstream fin(m_levelPath);
-    if (!fin)
+    if (!m_levelLoaded)
     {
         std::cerr << "[Level] Missing '" << m_levelPath << "', using fallback\n";
 
@@ -49,8 +167,6 @@ void Scene_Play::init()
         m_player->addComponent<CGravity>(Vec2{0.f, 0.2f});
 
         // add the animation
-        const Animation& idle = m_game->assets().getAnimation("Idle");
-        m_player->addComponent<CAnimation>(idle, /*repeat=*/false);
         auto& tf = m_player->getComponent<CTransform>();
         tf.scale = {4.f, 4.f};
 
@@ -64,20 +180,13 @@ void Scene_Play::init()
         sf::IntRect rect(sf::Vector2i{idleCol * frameW, idleRow * frameH},
                         sf::Vector2i{frameW, frameH});
 
-        auto& anim = m_player->getComponent<CAnimation>().animation;
-        auto& spr  = anim.getSprite();
-        spr.setTextureRect(rect);
-        spr.setOrigin(sf::Vector2f{frameW * 0.5f, frameH * 0.5f});
+        // frame clips are centred on the frame
+        m_player->addComponent<CAnimation>(m_game->assets().frameClip(m_anims.idle, rect), /*repeat=*/false);
 
-        spawnBlock(120.f, 360.f, 0, 0, 3.f);   // (px,py, col,row, scale)
-        spawnBlock(120.f+48.f, 360.f, 0, 0, 3.f);
-        spawnBlock(120.f+96.f, 360.f, 0, 0, 3.f);
+        const Vec2 blocks[] = { {120.f, 360.f}, {120.f + 48.f, 360.f}, {120.f + 96.f, 360.f} };
+        spawnBlocks(blocks, std::size(blocks), 0, 0, 3.f);   // (col,row, scale)
 
-        return;
     }
-
-    m_gridText.setCharacterSize(12);
-    m_gridText.setFont(m_game->assets().getFont("Tech"));
 }
 
 Vec2 Scene_Play::gridToMidPixel(float gx, float gy, std::shared_ptr<Entity>) {
@@ -85,71 +194,93 @@ Vec2 Scene_Play::gridToMidPixel(float gx, float gy, std::shared_ptr<Entity>) {
              gy * m_gridSize.y + m_gridSize.y * 0.5f };
 }
 
-void Scene_Play::loadLevel(const std::string & filename)
+// runs from load(), possibly off the main thread; see Scene::load
+bool Scene_Play::loadLevel(const std::string & filename)
 {
+    LevelData level;
+    if (!LevelLoader::load(filename, level)) return false;
+
     // reset the entity manager every time we load a level
     m_entityManager = EntityManager();
+    m_staticIndex.clear();
+    m_tileLayer.clear();
+    m_lightMap.clear();
+    m_lights.clear();
+
+    // the level is split into chunk files once, next to its .lvlc, and reused
+    // while it is unchanged; entities only exist near the camera
+    m_world.begin(m_worldDir, STREAM_CHUNK_CELLS * m_gridSize.x, filename + ".chunks", filename, m_worldIo);
+    if (!m_world.hasBase()) {
+        // one lookup per distinct name, for the tile bounding boxes
+        auto& assets = m_game->assets();
+        std::vector<AnimId> anims(level.names.size());
+        for (std::size_t i = 0; i < anims.size(); ++i) anims[i] = assets.getAnimationId(level.names[i]);
+
+        using Record = WorldStreamer::Record;
+        std::unordered_map<WorldStreamer::Key, WorldStreamer::ChunkData> chunks;
+        const auto add = [&](const std::string& tag, const std::string& anim, const Vec2& pos) -> Record& {
+            auto& chunk = chunks[m_world.keyOf(pos.x, pos.y)];
+            Record& r = chunk.records.emplace_back();
+            r.tag   = chunk.name(tag);
+            r.anim  = anim.empty() ? r.tag : chunk.name(anim);
+            r.flags = anim.empty() ? 0 : Record::HAS_ANIMATION | Record::REPEAT;
+            r.x     = pos.x;
+            r.y     = pos.y;
+            return r;
+        };
+        for (const auto& t : level.tiles) {
+            Record& r = add("tile", level.names[t.anim], gridToMidPixel(t.x, t.y));
+            const auto& size = assets.getAnimation(anims[t.anim]).size;
+            r.flags |= Record::HAS_BBOX;
+            r.bbw    = size.x;
+            r.bbh    = size.y;
+        }
+        for (const auto& d : level.decs) add("dec", level.names[d.anim], Vec2(d.x, d.y));
+        for (const auto& l : level.lights) {
+            Record& r = add("light", "", gridToMidPixel(l.x, l.y));
+            r.flags |= Record::HAS_LIGHT;
+            r.lightRadius    = l.radius;
+            r.lightIntensity = l.intensity;
+            r.lr = l.r; r.lg = l.g; r.lb = l.b; r.la = l.a;
+        }
+        m_world.writeBase(chunks);
+    }
 
-    // TODO: read in the level file and add the appropiate entites
-    //       use the PlayerConfig struct m_playerConfig to store player properties
-    //       this struct is defined at the top of Scene_Play.h
-
-    // NOTE: all of the code below is sample code which shows you how to
-    //       set up and use entities with the new syntax, it should be removed
+    if (level.player.present) {
+        const auto& p = level.player;
+        m_playerConfig = { p.x, p.y, p.cw, p.ch, p.speed, p.maxSpeed, p.jump, p.gravity, level.names[p.weapon] };
+    }
 
+    // the player's components are compiled once per level; spawning copies them
+    Prefab& player = m_prefabs.define("Player", "player");
+    player.add<CAnimation>(m_anims.stand, true);
+    player.add<CBoundingBox>(Vec2(m_playerConfig.CX, m_playerConfig.CY));
+    player.add<CInput>();
+    if (m_playerConfig.GRAVITY != 0.f) player.add<CGravity>(Vec2{0.f, m_playerConfig.GRAVITY});
+    m_playerPrefab = m_prefabs.find("Player");
     spawnPlayer();
 
-    // some sample entities
-    auto brick = m_entityManager.addEntity("tile");
-    // IMPORTANT: always add CAnimation component first so that gridToMidPixel can compute
-    brick->addComponent<CAnimation>(m_game->assets().getAnimation("Brick"), true);
-    brick->addComponent<CTransform>(Vec2(96, 480));
-    // NOTE: Your final code should position the entity with the grid x,y position read from
-    // brick->addComponent<CTransform>(gridToMidPixel(gridX, gridY, brick);
-
-    if (brick->getComponent<CAnimation>().animation.getName() == "Brick")
-    {
-        std::cout << "This could be a good way of identifying if a tile is a brick!\n";
-    }
-
-    auto block = m_entityManager.addEntity("tile");
-    block->addComponent<CAnimation>(m_game->assets().getAnimation("Block"), true);
-    block->addComponent<CTransform>(Vec2(224, 480));
-    // add a bounding box, this will now show up if we press the 'C' key
-    block->addComponent<CBoundingBox>(m_game->assets().getAnimation("Block").getSize());
-
-    auto question = m_entityManager.addEntity("tile");
-    question->addComponent<CAnimation>(m_game->assets().getAnimation("Question"), true);
-    question->addComponent<CTransform>(Vec2(352, 480));
-
-    // NOTE: THIS IS INCREDIBLY IMPORTANT PLESE READ THIS EXAMPLE
-    //       Components are now returned as reference rather than pointers
-    //       if you do not specify  a reference variable type, it will COPY the component
-    //       here is an example:
-    //
-    //       This will COPY the transform into the variable 'transform1' - it is INCORRECT
-    //       Any changes you make to transform1 will not be changed inside the entity
-    //       auto transform1 = entity->get<CTransform>()
-    //
-    //       This will REFERENCE the transform  with the variable 'transform2' - it is CORRECT
-    //       Now any changes you  make to transform2 will be changed inside the entity
-    //       auto& transform2 = entity->get<CTransform>()
+    // the chunks around the start are read before the first frame; update() spawns them
+    const sf::View view = camera();
+    m_world.update({ view.getCenter() - view.getSize() * 0.5f, view.getSize() });
+    m_world.waitLoads();
+    return true;
 }
 
 void Scene_Play::spawnPlayer()
 {
-    // here is a sample player entity which you can use to construct other entites
-    m_player = m_entityManager.addEntity("player");
-    m_player->addComponent<CAnimation>(m_game->assets().getAnimation("Stand"), true);
-    m_player->addComponent<CTransform>(Vec2(224, 352));
-    m_player->addComponent<CBoundingBox>(Vec2(48, 48));
-
-    // TODO: be sure to add the remaining components to the player
+    m_player = m_prefabs.spawn(m_entityManager, m_playerPrefab,
+                               gridToMidPixel(m_playerConfig.X, m_playerConfig.Y));
 }
 
 void Scene_Play::spawnBullet(std::shared_ptr<Entity> entity)
 {
-    // TODO: this should spawn a bullet at the given entity, going in the direction the entity is facing
+    // from the entity, in the direction it is facing
+    if (!m_bulletPrefab) return;
+    const auto& tf    = entity->getComponent<CTransform>();
+    const float speed = m_game->prefabs().get(m_bulletPrefab).speedMin;
+    const Vec2  vel{ tf.scale.x < 0.f ? -speed : speed, 0.f };
+    m_game->prefabs().spawn(m_entityManager, m_bulletPrefab, 1, &tf.pos, { &vel });
 }
 
 namespace {
@@ -157,39 +288,168 @@ constexpr int TILE_W = 16;      // adjust if your sheet uses 32
 constexpr int TILE_H = 16;
 }
 
-void Scene_Play::spawnBlock(float px, float py, int col, int row, float scale)
+void Scene_Play::spawnBlocks(const Vec2* positions, std::size_t count, int col, int row, float scale)
 {
-    auto e = m_entityManager.addEntity("tile");
-    e->addComponent<CTransform>(Vec2(px, py));
-    e->getComponent<CTransform>().scale = {2.f, 2.f};
+    Prefab& block = m_prefabs.define("Block", "tile");
+    block.get<CTransform>().scale = {2.f, 2.f};
 
     // collision box matches visual size
-    e->addComponent<CBoundingBox>(Vec2{TILE_W * scale, TILE_H * scale});
-
-    // 1-frame anim using the sheet, then crop to one tile
-    const Animation& sheet = m_game->assets().getAnimation("BlocksSheet");
-    e->addComponent<CAnimation>(sheet, false);
+    block.add<CBoundingBox>(Vec2{TILE_W * scale, TILE_H * scale});
 
+    // shared 1-frame clip cropped to one tile of the sheet (origin at its centre)
     sf::IntRect rect(sf::Vector2i{col * TILE_W, row * TILE_H},
                     sf::Vector2i{TILE_W,       TILE_H});
-    auto& spr = e->getComponent<CAnimation>().animation.getSprite();
-    spr.setTextureRect(rect);
-    spr.setOrigin(sf::Vector2f{TILE_W * 0.5f, TILE_H * 0.5f});
+    block.add<CAnimation>(m_game->assets().frameClip(m_anims.blocksSheet, rect), false);
+
+    m_prefabs.spawn(m_entityManager, m_prefabs.find("Block"), count, positions);
 }
 
 
 
+bool Scene_Play::isStreamed(const Entity& e) const
+{
+    // the player, input-driven and debug shape entities stay resident
+    return &e != m_player.get() && e.hasComponent<CTransform>()
+        && !e.hasComponent<CInput>() && !e.hasComponent<CShape>();
+}
+
+WorldStreamer::Record Scene_Play::record(const Entity& e, WorldStreamer::ChunkData& data) const
+{
+    using Record = WorldStreamer::Record;
+    Record r;
+    r.tag  = data.name(e.tag());
+    r.anim = r.tag;
+
+    const auto& tf = e.getComponent<CTransform>();
+    r.x  = tf.pos.x;      r.y  = tf.pos.y;
+    r.vx = tf.velocity.x; r.vy = tf.velocity.y;
+    r.sx = tf.scale.x;    r.sy = tf.scale.y;
+    r.angle = tf.angle;
+
+    if (const auto& ca = e.getComponent<CAnimation>(); ca.has) {
+        r.anim    = data.name(m_game->assets().getAnimation(ca.clip).name);
+        r.flags  |= Record::HAS_ANIMATION | (ca.repeat ? Record::REPEAT : 0u);
+        r.frame   = ca.frame;
+        r.elapsed = ca.elapsed;
+    }
+    if (const auto& bb = e.getComponent<CBoundingBox>(); bb.has) {
+        r.flags |= Record::HAS_BBOX;
+        r.bbw  = bb.size.x;   r.bbh  = bb.size.y;
+        r.bbox = bb.offset.x; r.bboy = bb.offset.y;
+    }
+    if (const auto& g = e.getComponent<CGravity>(); g.has) {
+        r.flags |= Record::HAS_GRAVITY;
+        r.gx = g.gravity.x; r.gy = g.gravity.y;
+    }
+    if (const auto& cl = e.getComponent<CLight>(); cl.has) {
+        r.flags |= Record::HAS_LIGHT;
+        r.lightRadius    = cl.radius;
+        r.lightIntensity = cl.intensity;
+        r.lr = cl.color.r; r.lg = cl.color.g; r.lb = cl.color.b; r.la = cl.color.a;
+    }
+    return r;
+}
+
+void Scene_Play::spawnChunk(WorldStreamer::Key key, const WorldStreamer::ChunkData& data)
+{
+    using Record = WorldStreamer::Record;
+
+    // names resolve once per chunk, not per entity; chunks load a chunk ahead
+    // of the view, so their textures have time to stream in
+    auto& assets = m_game->assets();
+    std::vector<AnimId> anims(data.names.size());
+    for (std::size_t i = 0; i < anims.size(); ++i) {
+        anims[i] = assets.findAnimationId(data.names[i]);
+        assets.prefetch(anims[i]);
+    }
+
+    auto& owned = m_world.entities(key);
+    for (const Record& r : data.records) {
+        auto e = m_entityManager.addEntity(data.names[r.tag]);
+        if (r.flags & Record::HAS_ANIMATION) {
+            auto& ca = e->addComponent<CAnimation>(anims[r.anim], (r.flags & Record::REPEAT) != 0);
+            ca.frame   = static_cast<std::uint16_t>(r.frame);
+            ca.elapsed = r.elapsed;
+        }
+        e->addComponent<CTransform>(Vec2(r.x, r.y), Vec2(r.vx, r.vy), r.angle, Vec2(r.sx, r.sy));
+        if (r.flags & Record::HAS_BBOX)    e->addComponent<CBoundingBox>(Vec2(r.bbw, r.bbh), Vec2(r.bbox, r.bboy));
+        if (r.flags & Record::HAS_GRAVITY) e->addComponent<CGravity>(Vec2(r.gx, r.gy));
+        if (r.flags & Record::HAS_LIGHT)
+            e->addComponent<CLight>(r.lightRadius, sf::Color(r.lr, r.lg, r.lb, r.la), r.lightIntensity);
+
+        // static entities belong to this chunk; moving ones are found by position when it unloads
+        if (isStaticTag(e->tag())) owned.push_back(e);
+    }
+}
+
+void Scene_Play::removeStatic(const std::shared_ptr<Entity>& e)
+{
+    e->destroy();
+    m_tileLayer.remove(*e);
+    if (e->hasComponent<CBoundingBox>()) {
+        const auto& p = e->getComponent<CTransform>().pos;
+        m_lightMap.removeOccluder(m_lightMap.cellOf(sf::Vector2f{p.x, p.y}));
+    }
+}
+
+void Scene_Play::sStreaming()
+{
+    if (!m_world.active()) return;
+    const sf::View view = camera();
+
+    // chunks far behind the camera: serialize everything in them, then drop it
+    for (WorldStreamer::Key key : m_world.update({ view.getCenter() - view.getSize() * 0.5f, view.getSize() })) {
+        WorldStreamer::ChunkData data;
+        for (auto& e : m_world.entities(key)) {
+            if (!e->isActive()) continue;
+            data.records.push_back(record(*e, data));
+            removeStatic(e);
+        }
+        for (auto& [tag, vec] : m_entityManager.getEntityMap()) {
+            if (isStaticTag(tag)) continue;
+            for (auto& e : vec) {
+                if (!e->isActive() || !isStreamed(*e)) continue;
+                const auto& p = e->getComponent<CTransform>().pos;
+                if (m_world.keyOf(p.x, p.y) != key) continue;
+                data.records.push_back(record(*e, data));
+                e->destroy();
+            }
+        }
+        m_world.store(key, std::move(data));
+    }
+
+    // moving entities that wandered off the resident area follow into their chunk's file
+    for (auto& [tag, vec] : m_entityManager.getEntityMap()) {
+        if (isStaticTag(tag)) continue;
+        for (auto& e : vec) {
+            if (!e->isActive() || !isStreamed(*e)) continue;
+            const auto& p = e->getComponent<CTransform>().pos;
+            const WorldStreamer::Key key = m_world.keyOf(p.x, p.y);
+            if (m_world.resident(key)) continue;
+            WorldStreamer::ChunkData data;
+            data.records.push_back(record(*e, data));
+            if (m_world.migrate(key, std::move(data))) e->destroy();
+        }
+    }
+
+    // recorded sessions must spawn the same chunks on the same frame, whatever the disk does
+    if (m_game->deterministic()) m_world.waitLoads();
+    for (auto& [key, data] : m_world.takeLoaded()) spawnChunk(key, data);
+}
+
 void Scene_Play::update()
 {
+    sStreaming();
     m_entityManager.update();
+    sSpatialIndex();
 
     // TODO: implement pause functionality
 
     sMovement();
     sLifespan();
     sCollision();
-    //sAnimation();
-    sRender();
+    sAnimation();
+    sLighting();
 
     if (m_player)
     {
@@ -262,7 +522,13 @@ void Scene_Play::sMovement()
 
 void Scene_Play::sLifespan()
 {
-    //TODO: Check lifespan of entities that have them, and destroy them if they go over
+    for (auto& e : m_entityManager.getEntities())
+    {
+        if (!e->hasComponent<CLifespan>()) continue;
+        auto& life = e->getComponent<CLifespan>();
+        life.remaining -= SIM_DT;
+        if (life.remaining <= 0.f) e->destroy();
+    }
 }
 
 void Scene_Play::sCollision()
@@ -331,119 +597,214 @@ void Scene_Play::sCollision()
         if (!b->hasComponent<CBoundingBox>()) continue;
 
         for (auto& t : m_entityManager.getEntities("tile")) {
-            if (!t->hasComponent<CBoundingBox>()) continue;
+            // a brick broken earlier this frame stays listed until the next update()
+            if (!t->isActive() || !t->hasComponent<CBoundingBox>()) continue;
 
             Vec2 ov = Physics::GetOverlap(b, t);
             if (ov.x <= 0.f || ov.y <= 0.f) continue;
 
             b->destroy();
             if (t->hasComponent<CAnimation>()) {
-                auto& ca = t->getComponent<CAnimation>();
-                const std::string n = !ca.name.empty() ? ca.name : ca.animation.getName();
-                if (n == "Brick") t->destroy();
+                const auto& ca = t->getComponent<CAnimation>();
+                if (m_anims.brick && ca.clip == m_anims.brick) {
+                    removeStatic(t);
+                    const auto& p = t->getComponent<CTransform>().pos;
+                    // headless worlds are silent; server rooms would share the mixer across threads
+                    if (!m_game->headless()) m_game->audio().playAt(m_breakSound, sf::Vector2f{p.x, p.y});
+                }
             }
             break;
         }
     }
 }
 
-void Scene_Play::sDoAction(const Action& action)
+void Scene_Play::sAnimation()
 {
-    if (!m_player) return;
-
-    auto& in = m_player->getComponent<CInput>();
-
-    if (action.isStart()) {
-        if (action.name() == "UP")    in.up    = true;
-        if (action.name() == "DOWN")  in.down  = true;
-        if (action.name() == "LEFT")  in.left  = true;
-        if (action.name() == "RIGHT") in.right = true;
+    const Assets& assets = m_game->assets();
+
+    // player clip follows its state; play() keeps the playhead if the clip is unchanged
+    if (m_player && m_player->hasComponent<CState>() && m_player->hasComponent<CAnimation>()) {
+        const auto& state = m_player->getComponent<CState>().state;
+        AnimId want;
+        if (state == "air") want = m_anims.air;
+        if (state == "run") want = m_anims.run;
+        if (want) m_player->getComponent<CAnimation>().play(want);
+    }
 
-        if (action.name() == "TOGGLE_TEXTURE")   m_drawTextures  = !m_drawTextures;
-        if (action.name() == "TOGGLE_COLLISION") m_drawCollision = !m_drawCollision;
-        if (action.name() == "TOGGLE_GRID")      m_drawGrid      = !m_drawGrid;
-    } else {
-        if (action.name() == "UP")    in.up    = false;
-        if (action.name() == "DOWN")  in.down  = false;
-        if (action.name() == "LEFT")  in.left  = false;
-        if (action.name() == "RIGHT") in.right = false;
+    // one pass over every playhead; finished one-shot animations remove their entity
+    for (auto& e : m_entityManager.getEntities()) {
+        auto& ca = e->getComponent<CAnimation>();
+        if (!ca.has || ca.ended) continue;
+        const auto& clip = assets.getAnimation(ca.clip);
+        if (clip.length <= 0.f) continue;
+        ca.advance(clip, SIM_DT);
+        if (ca.ended) e->destroy();
     }
 }
 
-void Scene_Play::sAnimation()
+void Scene_Play::sSpatialIndex()
 {
-    // TODO: Complete the Animation class code first
-
-    if (m_player->getComponent<CState>().state == "air")
-    {
-        m_player->addComponent<CAnimation>(m_game->assets().getAnimation("Air"));
+    // dead entities leave the index in the same frame the entity manager drops them
+    for (auto& e : m_entityManager.getRemovedEntities())
+        if (isStaticTag(e->tag())) m_staticIndex.remove(e->id());
+
+    // sprite tiles are baked into the chunked tile layer, anything else static is indexed
+    for (auto& e : m_entityManager.getAddedEntities()) {
+        if (!e->isActive()) continue;
+        if (e->hasComponent<CLight>()) m_lights.push_back(e);
+        if (!isStaticTag(e->tag())) continue;
+        const auto& clip = m_game->assets().getAnimation(e->getComponent<CAnimation>().clip);
+        if (TileLayer::canBake(*e, clip)) m_tileLayer.add(e, clip);
+        else                              m_staticIndex.insert(e, renderBounds(*e, m_game->assets()));
+
+        // solid static tiles cast shadows
+        if (e->hasComponent<CBoundingBox>() && e->hasComponent<CTransform>()) {
+            const auto& p = e->getComponent<CTransform>().pos;
+            m_lightMap.addOccluder(m_lightMap.cellOf(sf::Vector2f{p.x, p.y}));
+        }
     }
+}
 
-    if (m_player->getComponent<CState>().state == "run")
-    {
-        m_player->addComponent<CAnimation>(m_game->assets().getAnimation("Run"));
+void Scene_Play::sLighting()
+{
+    // push light entities into the light map; set() is a no-op unless the light
+    // changed cell, radius or colour, so idle lights cost a compare per frame
+    for (auto it = m_lights.begin(); it != m_lights.end();) {
+        auto& e  = *it;
+        auto& cl = e->getComponent<CLight>();
+        if (!e->isActive() || !cl.has) {
+            m_lightMap.remove(cl.handle);
+            cl.handle = 0;
+            it = m_lights.erase(it);
+            continue;
+        }
+
+        const auto& p = e->getComponent<CTransform>().pos;
+        const LightMap::Light light{ m_lightMap.cellOf(sf::Vector2f{p.x, p.y}),
+                                     std::max(1, static_cast<int>(cl.radius / m_gridSize.x)),
+                                     cl.color, cl.intensity };
+        if (cl.handle == 0) cl.handle = m_lightMap.add(light);
+        else                m_lightMap.set(cl.handle, light);
+        ++it;
     }
-    // TODO: set the animation of the player based on its CState component
-    // TODO: fot each entity with an animation, call entity->getComponent<CAnimation>().animation.update()
-    //       if the animation is not repeated, and it has ended, destroy the entity
 }
 
 void Scene_Play::onEnd()
 {
     // TODO: When the scene ends, change back to the MENU scene
     //       use m_game->changeScene(correct params);
+
+    // flush chunk writes now rather than whenever the scene is finally released
+    m_world.end();
+}
+sf::View Scene_Play::camera() const
+{
+    // follows the player horizontally, never scrolling left of the level start
+    const auto size = m_game->size();
+    sf::View view(sf::FloatRect({0.f, 0.f}, sf::Vector2f(size)));
+    if (m_player && m_player->hasComponent<CTransform>()) {
+        const auto& p = m_player->getComponent<CTransform>().pos;
+        float cx = std::max(size.x * 0.5f, p.x);
+        view.setCenter(sf::Vector2f{cx, size.y * 0.5f});
+    } else {
+        view.setCenter(sf::Vector2f{size.x * 0.5f, size.y * 0.5f});
+    }
+    return view;
 }
+
 void Scene_Play::sRender() {
-    auto& win = m_game->window();
+    auto& frame = m_game->renderFrame();
 
-    // set camera
+    const sf::View view = camera();
+    frame.setView(view);
+    m_game->audio().setListener(view.getCenter());
+
+    // cull to the view (plus a margin); sorting by id keeps submission order deterministic
+    const sf::Vector2f margin{m_cullMargin, m_cullMargin};
+    const sf::FloatRect area{ view.getCenter() - view.getSize() * 0.5f - margin,
+                              view.getSize() + margin * 2.f };
     {
-        auto size = win.getSize();
-        sf::View view = win.getView();
-        if (m_player && m_player->hasComponent<CTransform>()) {
-            const auto& p = m_player->getComponent<CTransform>().pos;
-            float cx = std::max(size.x * 0.5f, p.x);
-            view.setCenter(sf::Vector2f{cx, size.y * 0.5f});
-        } else {
-            view.setCenter(sf::Vector2f{size.x * 0.5f, size.y * 0.5f});
+        m_visible.clear();
+        m_staticIndex.query(area, m_visible);
+        for (auto& [tag, vec] : m_entityManager.getEntityMap()) {
+            if (isStaticTag(tag)) continue;
+            for (auto& e : vec)
+                if (e->isActive() && overlaps(renderBounds(*e, m_game->assets()), area)) m_visible.push_back(e);
         }
-        win.setView(view);
+        std::sort(m_visible.begin(), m_visible.end(),
+                  [](const auto& a, const auto& b) { return a->id() < b->id(); });
+
+        // baked tiles are accounted for by the tile layer, not the entity path
+        const std::size_t all = m_entityManager.getEntities().size();
+        m_renderStats.total   = all - std::min(all, m_tileLayer.tileCount());
+        m_renderStats.visible = m_visible.size();
+        m_renderStats.culled  = m_renderStats.total > m_renderStats.visible
+                              ? m_renderStats.total - m_renderStats.visible : 0;
     }
 
-    // draw entities once, honoring toggles
-    for (auto& e : m_entityManager.getEntities()) {
+    // baked static tiles: one draw per visible chunk and texture
+    m_tileLayer.resetStats();
+    if (m_drawTextures) {
+        m_tileLayer.draw(m_renderQueue, RenderLayer::Tiles, area);
+        for (TextureId id : m_tileLayer.texturesDrawn()) m_game->assets().useTexture(id);
+    }
+    m_renderStats.chunks  = m_tileLayer.chunksDrawn();
+    m_renderStats.rebakes = m_tileLayer.rebakes();
+
+    // submit entities with their layer; the queue sorts by layer, depth and state
+    std::size_t quads = 0;
+    for (auto& e : m_visible) {
         auto& tf = e->getComponent<CTransform>();
         auto& ca = e->getComponent<CAnimation>();
         auto& sh = e->getComponent<CShape>();
+        const auto& cl = e->getComponent<CLayer>();
+
+        const RenderLayer layer = cl.has ? static_cast<RenderLayer>(cl.layer)
+                                : isStaticTag(e->tag()) ? RenderLayer::Tiles : RenderLayer::Entities;
+        const float depth = cl.has ? cl.depth : 0.f;
 
         if (m_drawTextures && ca.has) {
-            auto& spr = ca.animation.getSprite();
-            spr.setPosition(sf::Vector2f{tf.pos.x, tf.pos.y});
-            spr.setScale   (sf::Vector2f{tf.scale.x, tf.scale.y});
-            spr.setRotation(sf::degrees(tf.angle));
-            win.draw(spr);
+            const auto& clip = m_game->assets().getAnimation(ca.clip);
+            if (!clip.texture) continue;
+            m_game->assets().useTexture(clip);
+            m_renderQueue.drawSprite(layer, depth, *clip.texture, ca.rect(clip), clip.origin,
+                                     sf::Vector2f{tf.pos.x, tf.pos.y},
+                                     sf::Vector2f{tf.scale.x, tf.scale.y},
+                                     tf.angle, sf::Color::White);
+            ++quads;
         } else if (sh.has && sh.shape) {
             sh.shape->setPosition(sf::Vector2f{tf.pos.x, tf.pos.y});
             sh.shape->setScale   (sf::Vector2f{tf.scale.x, tf.scale.y});
             sh.shape->setRotation(sf::degrees(tf.angle));
-            win.draw(*sh.shape);
+            m_renderQueue.draw(layer, depth, *sh.shape);
         }
     }
+    m_renderQueue.flush(frame);
+    m_renderStats.quads     = quads;
+    m_renderStats.drawCalls = m_renderQueue.batches();
+
+    // lighting: the light map multiplied over everything drawn so far, in one quad
+    m_renderStats.relit = 0;
+    if (m_drawLighting && m_lightMap.lightCount() > 0) {
+        m_lightMap.follow(area);
+        m_lightMap.update();
+        m_renderStats.relit = m_lightMap.cellsRelit();
+
+        sf::Vertex quad[6];
+        m_lightMap.quad(quad);
+        frame.draw(m_lightMap.image(), quad, sf::BlendMultiply);
+    }
 
     // collision boxes
     if (m_drawCollision) {
-        for (auto& e : m_entityManager.getEntities()) {
+        m_debugEntities.assign(m_visible.begin(), m_visible.end());
+        m_tileLayer.query(area, m_debugEntities);
+        for (auto& e : m_debugEntities) {
             if (!e->hasComponent<CBoundingBox>()) continue;
             const auto& box = e->getComponent<CBoundingBox>();
             const auto& tr  = e->getComponent<CTransform>();
-            sf::RectangleShape r;
-            r.setSize(sf::Vector2f{box.size.x - 1.f, box.size.y - 1.f});
-            r.setOrigin(sf::Vector2f{box.halfSize.x, box.halfSize.y});
-            r.setPosition(sf::Vector2f{tr.pos.x, tr.pos.y});
-            r.setFillColor(sf::Color(0,0,0,0));
-            r.setOutlineColor(sf::Color(255,255,255,255));
-            r.setOutlineThickness(1.f);
-            win.draw(r);
+            m_debugDraw.rect(Vec2{tr.pos.x - box.halfSize.x, tr.pos.y - box.halfSize.y},
+                             Vec2{box.size.x - 1.f, box.size.y - 1.f});
         }
     }
 
@@ -453,6 +814,9 @@ void Scene_Play::sRender() {
         float rightX  = static_cast<float>(width());
         float nextGX  = leftX - std::fmod(leftX, m_gridSize.x);
 
+        const sf::Font& font = m_gridText.getFont();
+        const unsigned  size = m_gridText.getCharacterSize();
+
         for (float x = nextGX; x < rightX; x += m_gridSize.x)
             drawLine(Vec2{x, 0.f}, Vec2{x, static_cast<float>(height())});
 
@@ -460,12 +824,20 @@ void Scene_Play::sRender() {
             drawLine(Vec2{leftX, static_cast<float>(height()) - y},
                      Vec2{rightX, static_cast<float>(height()) - y});
             for (float x = nextGX; x < rightX; x += m_gridSize.x) {
-                std::string xCell = std::to_string(static_cast<int>(x / m_gridSize.x));
-                std::string yCell = std::to_string(static_cast<int>(y / m_gridSize.y));
-                m_gridText.setString("(" + xCell + "," + yCell + ")");
-                m_gridText.setPosition(sf::Vector2f{x + 3.f, static_cast<float>(height()) - y - m_gridSize.y + 2.f});
-                win.draw(m_gridText);
+                // "(x,y)" formatted in place, no string allocations
+                char label[32];
+                char* p = label;
+                *p++ = '(';
+                p = std::to_chars(p, label + sizeof(label), static_cast<int>(x / m_gridSize.x)).ptr;
+                *p++ = ',';
+                p = std::to_chars(p, label + sizeof(label), static_cast<int>(y / m_gridSize.y)).ptr;
+                *p++ = ')';
+                m_debugDraw.text(font, size,
+                                 Vec2{x + 3.f, static_cast<float>(height()) - y - m_gridSize.y + 2.f},
+                                 std::string_view(label, static_cast<std::size_t>(p - label)));
             }
         }
     }
+
+    m_debugDraw.flush(frame);
 }
@@ -0,0 +1,118 @@
+#include "../include/SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    inline bool overlaps(const sf::FloatRect & a, const sf::FloatRect & b)
+    {
+        return a.position.x < b.position.x + b.size.x && b.position.x < a.position.x + a.size.x
+            && a.position.y < b.position.y + b.size.y && b.position.y < a.position.y + a.size.y;
+    }
+}
+
+SpatialGrid::SpatialGrid(float cellSize)
+: m_cellSize(cellSize > 0.f ? cellSize : 256.f)
+{
+}
+
+std::uint64_t SpatialGrid::key(int cx, int cy)
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32)
+         |  static_cast<std::uint64_t>(static_cast<std::uint32_t>(cy));
+}
+
+int SpatialGrid::cellOf(float v) const
+{
+    return static_cast<int>(std::floor(v / m_cellSize));
+}
+
+void SpatialGrid::link(std::size_t id, const Record & r)
+{
+    for (int cy = r.y0; cy <= r.y1; ++cy)
+        for (int cx = r.x0; cx <= r.x1; ++cx)
+            m_cells[key(cx, cy)].push_back(id);
+}
+
+void SpatialGrid::unlink(std::size_t id, const Record & r)
+{
+    for (int cy = r.y0; cy <= r.y1; ++cy)
+    {
+        for (int cx = r.x0; cx <= r.x1; ++cx)
+        {
+            auto it = m_cells.find(key(cx, cy));
+            if (it == m_cells.end()) continue;
+
+            auto & ids = it->second;
+            auto pos = std::find(ids.begin(), ids.end(), id);
+            if (pos != ids.end()) { *pos = ids.back(); ids.pop_back(); }
+            if (ids.empty()) m_cells.erase(it);
+        }
+    }
+}
+
+void SpatialGrid::insert(const std::shared_ptr<Entity> & entity, const sf::FloatRect & bounds)
+{
+    const int x0 = cellOf(bounds.position.x);
+    const int y0 = cellOf(bounds.position.y);
+    const int x1 = cellOf(bounds.position.x + bounds.size.x);
+    const int y1 = cellOf(bounds.position.y + bounds.size.y);
+
+    auto & r = m_records[entity->id()];
+    if (r.entity && r.x0 == x0 && r.y0 == y0 && r.x1 == x1 && r.y1 == y1)
+    {
+        r.bounds = bounds;
+        return;
+    }
+
+    if (r.entity) unlink(entity->id(), r);
+    r.entity = entity;
+    r.bounds = bounds;
+    r.x0 = x0; r.y0 = y0; r.x1 = x1; r.y1 = y1;
+    link(entity->id(), r);
+}
+
+void SpatialGrid::remove(std::size_t id)
+{
+    auto it = m_records.find(id);
+    if (it == m_records.end()) return;
+    unlink(id, it->second);
+    m_records.erase(it);
+}
+
+void SpatialGrid::clear()
+{
+    m_cells.clear();
+    m_records.clear();
+}
+
+void SpatialGrid::query(const sf::FloatRect & area, EntityVec & out)
+{
+    // stamp records so entities spanning several cells are reported once
+    ++m_stamp;
+
+    const int x0 = cellOf(area.position.x);
+    const int y0 = cellOf(area.position.y);
+    const int x1 = cellOf(area.position.x + area.size.x);
+    const int y1 = cellOf(area.position.y + area.size.y);
+
+    for (int cy = y0; cy <= y1; ++cy)
+    {
+        for (int cx = x0; cx <= x1; ++cx)
+        {
+            auto it = m_cells.find(key(cx, cy));
+            if (it == m_cells.end()) continue;
+
+            for (std::size_t id : it->second)
+            {
+                auto & r = m_records[id];
+                if (r.stamp == m_stamp) continue;
+                r.stamp = m_stamp;
+
+                if (r.entity->isActive() && overlaps(r.bounds, area)) out.push_back(r.entity);
+            }
+        }
+    }
+}
+
+std::size_t SpatialGrid::size()     const { return m_records.size(); }
+float       SpatialGrid::cellSize() const { return m_cellSize; }
@@ -0,0 +1,312 @@
+#include "../include/TextLayer.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace {
+    // same skew sf::Text uses for italic (12 degrees)
+    constexpr float ITALIC_SHEAR = 0.2094395102393195f;
+
+    char32_t nextCodepoint(std::string_view s, std::size_t & i)
+    {
+        const auto c = static_cast<unsigned char>(s[i++]);
+        if (c < 0x80) return c;
+
+        int      extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+        char32_t cp    = c & (0x3F >> extra);
+        while (extra-- > 0 && i < s.size())
+            cp = (cp << 6) | (static_cast<unsigned char>(s[i++]) & 0x3F);
+        return cp;
+    }
+
+    void addQuad(std::vector<sf::Vertex> & out, float l, float t, float r, float b,
+                 const sf::FloatRect & uv, float shear)
+    {
+        const float u0 = uv.position.x, v0 = uv.position.y;
+        const float u1 = u0 + uv.size.x, v1 = v0 + uv.size.y;
+        const sf::Color w = sf::Color::White;
+        out.insert(out.end(), {
+            { {l - shear * t, t}, w, {u0, v0} }, { {r - shear * t, t}, w, {u1, v0} },
+            { {l - shear * b, b}, w, {u0, v1} }, { {l - shear * b, b}, w, {u0, v1} },
+            { {r - shear * t, t}, w, {u1, v0} }, { {r - shear * b, b}, w, {u1, v1} } });
+    }
+}
+
+TextLayer::Page & TextLayer::pageFor(const sf::Font & font, unsigned size)
+{
+    for (auto & p : m_pages)
+        if (p.font == &font && p.size == size) return p;
+
+    // rasterize the common glyphs now, so laying them out never writes to the font texture
+    Page page;
+    page.font = &font;
+    page.size = size;
+    std::lock_guard<std::mutex> lock(glyphMutex());
+    for (char32_t c = U' '; c <= U'~'; ++c) {
+        font.getGlyph(c, size, false);
+        font.getGlyph(c, size, true);
+    }
+    page.texture = &font.getTexture(size);
+    m_pages.push_back(std::move(page));
+    return m_pages.back();
+}
+
+// true if every glyph of str is already rasterized; the rest are recorded as
+// rasterized, since the caller lays them out under the glyph lock next
+bool TextLayer::rasterized(Page & page, std::string_view str, bool bold)
+{
+    bool all = true;
+    for (std::size_t i = 0; i < str.size();) {
+        const char32_t c = nextCodepoint(str, i);
+        if (c >= U' ' && c <= U'~') continue;
+        if (page.glyphs.insert((static_cast<std::uint64_t>(c) << 1) | bold).second) all = false;
+    }
+    return all;
+}
+
+TextLayer::Page * TextLayer::findPage(const Label & label)
+{
+    for (auto & p : m_pages)
+        if (p.font == label.font && p.size == label.size) return &p;
+    return nullptr;
+}
+
+void TextLayer::touch(const Label & label)
+{
+    if (Page * p = findPage(label)) p->dirty = true;
+}
+
+void TextLayer::detach(LabelId id, const Label & label)
+{
+    Page * p = findPage(label);
+    if (!p) return;
+    p->labels.erase(std::remove(p->labels.begin(), p->labels.end(), id), p->labels.end());
+    p->dirty = true;
+}
+
+TextLayer::LabelId TextLayer::add(const sf::Font & font, unsigned size, std::string_view str,
+                                  const Vec2 & pos, const sf::Color & color, std::uint32_t style)
+{
+    const LabelId id = m_nextId++;
+    Label & l = m_labels[id];
+    l.font   = &font;
+    l.size   = size;
+    l.style  = style;
+    l.string = str;
+    l.pos    = pos;
+    l.color  = color;
+
+    Page & p = pageFor(font, size);
+    p.labels.push_back(id);
+    p.dirty = true;
+    return id;
+}
+
+void TextLayer::remove(LabelId id)
+{
+    auto it = m_labels.find(id);
+    if (it == m_labels.end()) return;
+    detach(id, it->second);
+    m_labels.erase(it);
+}
+
+void TextLayer::clear()
+{
+    m_labels.clear();
+    m_pages.clear();
+}
+
+void TextLayer::setString(LabelId id, std::string_view str)
+{
+    auto it = m_labels.find(id);
+    if (it == m_labels.end() || it->second.string == str) return;
+    it->second.string.assign(str);
+    it->second.dirty = true;
+    touch(it->second);
+}
+
+void TextLayer::setNumber(LabelId id, long long value)
+{
+    char buf[24];
+    const auto res = std::to_chars(buf, buf + sizeof(buf), value);
+    setString(id, std::string_view(buf, static_cast<std::size_t>(res.ptr - buf)));
+}
+
+void TextLayer::setFont(LabelId id, const sf::Font & font, unsigned size)
+{
+    auto it = m_labels.find(id);
+    if (it == m_labels.end()) return;
+    Label & l = it->second;
+    if (l.font == &font && l.size == size) return;
+
+    detach(id, l);
+    l.font  = &font;
+    l.size  = size;
+    l.dirty = true;
+    Page & p = pageFor(font, size);
+    p.labels.push_back(id);
+    p.dirty = true;
+}
+
+void TextLayer::setStyle(LabelId id, std::uint32_t style)
+{
+    auto it = m_labels.find(id);
+    if (it == m_labels.end() || it->second.style == style) return;
+    it->second.style = style;
+    it->second.dirty = true;
+    touch(it->second);
+}
+
+void TextLayer::setPosition(LabelId id, const Vec2 & pos)
+{
+    auto it = m_labels.find(id);
+    if (it == m_labels.end() || it->second.pos == pos) return;
+    it->second.pos = pos;
+    touch(it->second);
+}
+
+void TextLayer::setColor(LabelId id, const sf::Color & color)
+{
+    auto it = m_labels.find(id);
+    if (it == m_labels.end() || it->second.color == color) return;
+    it->second.color = color;
+    touch(it->second);
+}
+
+void TextLayer::setVisible(LabelId id, bool visible)
+{
+    auto it = m_labels.find(id);
+    if (it == m_labels.end() || it->second.visible == visible) return;
+    it->second.visible = visible;
+    touch(it->second);
+}
+
+sf::FloatRect TextLayer::bounds(LabelId id)
+{
+    auto it = m_labels.find(id);
+    if (it == m_labels.end()) return {};
+    Label & l = it->second;
+    if (l.dirty) layout(l);
+    return { l.bounds.position + sf::Vector2f{l.pos.x, l.pos.y}, l.bounds.size };
+}
+
+void TextLayer::layout(Label & label)
+{
+    // mirrors sf::Text's geometry: baseline one character size below the top,
+    // kerning between pairs, 1px glyph padding
+    const sf::Font & font  = *label.font;
+    const unsigned   size  = label.size;
+    const bool       bold  = (label.style & sf::Text::Bold) != 0;
+    const bool       under = (label.style & sf::Text::Underlined) != 0;
+    const float      shear = (label.style & sf::Text::Italic) ? ITALIC_SHEAR : 0.f;
+    const float      padding = 1.f;
+
+    std::unique_lock<std::mutex> lock(glyphMutex(), std::defer_lock);
+    if (!rasterized(pageFor(font, size), label.string, bold)) lock.lock();
+
+    const float whitespace  = font.getGlyph(U' ', size, bold).advance;
+    const float lineSpacing = font.getLineSpacing(size);
+    const float underPos    = font.getUnderlinePosition(size);
+    const float underThick  = font.getUnderlineThickness(size);
+    const sf::FloatRect whitePixel{ {1.f, 1.f}, {1.f, 1.f} };
+
+    label.layout.clear();
+    float x = 0.f;
+    float y = static_cast<float>(size);
+    float minX = 0.f, minY = 0.f, maxX = 0.f, maxY = 0.f;
+    char32_t prev = 0;
+
+    const auto underline = [&]()
+    {
+        if (under && x > 0.f)
+            addQuad(label.layout, 0.f, y + underPos - underThick * 0.5f, x,
+                    y + underPos + underThick * 0.5f, whitePixel, 0.f);
+    };
+
+    for (std::size_t i = 0; i < label.string.size();)
+    {
+        const char32_t cur = nextCodepoint(label.string, i);
+        if (cur == U'\r') continue;
+
+        x += font.getKerning(prev, cur, size, bold);
+        prev = cur;
+
+        if (cur == U' ' || cur == U'\t' || cur == U'\n')
+        {
+            if (cur == U' ')  x += whitespace;
+            if (cur == U'\t') x += whitespace * 4.f;
+            if (cur == U'\n')
+            {
+                underline();
+                y += lineSpacing;
+                x  = 0.f;
+            }
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+            continue;
+        }
+
+        const sf::Glyph & g = font.getGlyph(cur, size, bold);
+        const float l = x + g.bounds.position.x - padding;
+        const float t = y + g.bounds.position.y - padding;
+        const float r = x + g.bounds.position.x + g.bounds.size.x + padding;
+        const float b = y + g.bounds.position.y + g.bounds.size.y + padding;
+        const sf::FloatRect uv{ sf::Vector2f(g.textureRect.position) - sf::Vector2f{padding, padding},
+                                sf::Vector2f(g.textureRect.size) + sf::Vector2f{2.f * padding, 2.f * padding} };
+        addQuad(label.layout, l, t, r, b, uv, shear);
+
+        minX = std::min(minX, l - shear * b);
+        maxX = std::max(maxX, r - shear * t);
+        minY = std::min(minY, t);
+        maxY = std::max(maxY, b);
+        x += g.advance;
+    }
+    underline();
+
+    label.bounds = { {minX, minY}, {maxX - minX, maxY - minY} };
+    label.dirty  = false;
+    ++m_layouts;
+}
+
+void TextLayer::rebuild(Page & page)
+{
+    page.vertices.clear();
+    for (LabelId id : page.labels)
+    {
+        Label & l = m_labels[id];
+        if (l.dirty) layout(l);
+        if (!l.visible) continue;
+
+        const sf::Vector2f offset{ l.pos.x, l.pos.y };
+        for (sf::Vertex v : l.layout)
+        {
+            v.position += offset;
+            v.color     = l.color;
+            page.vertices.push_back(v);
+        }
+    }
+    page.dirty = false;
+    ++m_pageRebuilds;
+}
+
+void TextLayer::draw(RenderFrame & frame)
+{
+    for (auto & p : m_pages)
+    {
+        if (p.dirty) rebuild(p);
+        if (p.vertices.empty()) continue;
+        frame.draw(p.vertices.data(), p.vertices.size(), sf::PrimitiveType::Triangles, p.texture);
+        ++m_drawCalls;
+    }
+}
+
+std::size_t TextLayer::layouts()      const { return m_layouts; }
+std::size_t TextLayer::pageRebuilds() const { return m_pageRebuilds; }
+std::size_t TextLayer::drawCalls()    const { return m_drawCalls; }
+
+void TextLayer::resetStats()
+{
+    m_layouts      = 0;
+    m_pageRebuilds = 0;
+    m_drawCalls    = 0;
+}
@@ -0,0 +1,327 @@
+#include "../include/TextureAtlas.h"
+#include <algorithm>
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // every region is surrounded by a 1px copy of its own edge pixels so that
+    // filtered sampling never bleeds in a neighbour
+    constexpr int BORDER = 1;
+
+    // skyline bottom-left rectangle packer
+    class Skyline
+    {
+        struct Node { int x, y, w; };
+
+        std::vector<Node> m_nodes;
+        int               m_width;
+        int               m_height;
+
+        int fit(std::size_t i, int w, int h) const
+        {
+            if (m_nodes[i].x + w > m_width) return -1;
+            int y = 0;
+            for (std::size_t j = i, left = 0; static_cast<int>(left) < w; ++j) {
+                if (j == m_nodes.size()) return -1;
+                y = std::max(y, m_nodes[j].y);
+                if (y + h > m_height) return -1;
+                left += m_nodes[j].w;
+            }
+            return y;
+        }
+
+    public:
+
+        Skyline(int w, int h) : m_nodes{{0, 0, w}}, m_width(w), m_height(h) {}
+
+        std::optional<sf::Vector2i> insert(int w, int h)
+        {
+            int bestTop = INT_MAX, bestW = INT_MAX;
+            std::size_t best = m_nodes.size();
+            for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+                const int y = fit(i, w, h);
+                if (y < 0) continue;
+                if (y + h < bestTop || (y + h == bestTop && m_nodes[i].w < bestW)) {
+                    bestTop = y + h;
+                    bestW   = m_nodes[i].w;
+                    best    = i;
+                }
+            }
+            if (best == m_nodes.size()) return std::nullopt;
+
+            const sf::Vector2i pos{m_nodes[best].x, bestTop - h};
+            m_nodes.insert(m_nodes.begin() + best, Node{pos.x, bestTop, w});
+
+            // trim the nodes the new one now covers
+            for (std::size_t i = best + 1; i < m_nodes.size();) {
+                const int end = m_nodes[i - 1].x + m_nodes[i - 1].w;
+                if (m_nodes[i].x >= end) break;
+                const int shrink = end - m_nodes[i].x;
+                m_nodes[i].x += shrink;
+                m_nodes[i].w -= shrink;
+                if (m_nodes[i].w > 0) break;
+                m_nodes.erase(m_nodes.begin() + i);
+            }
+
+            // merge neighbours at the same height
+            for (std::size_t i = 0; i + 1 < m_nodes.size();) {
+                if (m_nodes[i].y == m_nodes[i + 1].y) {
+                    m_nodes[i].w += m_nodes[i + 1].w;
+                    m_nodes.erase(m_nodes.begin() + i + 1);
+                } else {
+                    ++i;
+                }
+            }
+            return pos;
+        }
+    };
+
+    struct Group
+    {
+        const TextureAtlas::Source * source = nullptr;
+        sf::Image                    image;
+        std::vector<sf::IntRect>     rects;
+        long long                    area = 0;
+    };
+
+    void blit(sf::Image & page, const sf::Image & src, const sf::IntRect & r, sf::Vector2i dst)
+    {
+        auto copy = [&](sf::Vector2i to, sf::IntRect from) {
+            if (!page.copy(src, sf::Vector2u(to), from))
+                std::cerr << "[Assets] Atlas copy failed\n";
+        };
+
+        const int w = r.size.x, h = r.size.y;
+        const sf::Vector2i p = r.position;
+
+        copy(dst, r);
+        copy(dst + sf::Vector2i{0, -BORDER}, {p,                 {w, 1}});
+        copy(dst + sf::Vector2i{0,  h},      {p + sf::Vector2i{0, h - 1}, {w, 1}});
+        copy(dst + sf::Vector2i{-BORDER, 0}, {p,                 {1, h}});
+        copy(dst + sf::Vector2i{w, 0},       {p + sf::Vector2i{w - 1, 0}, {1, h}});
+    }
+
+    std::string makeSignature(const std::vector<TextureAtlas::Source> & sources, unsigned pageSize)
+    {
+        std::ostringstream oss;
+        oss << pageSize;
+        for (const auto & s : sources) {
+            std::error_code ec;
+            const auto size  = fs::file_size(s.path, ec);
+            const auto mtime = fs::last_write_time(s.path, ec).time_since_epoch().count();
+            oss << '|' << s.name << '|' << s.path << '|' << size << '|' << mtime << '|' << s.smooth;
+            for (const auto & r : s.rects)
+                oss << ':' << r.position.x << ',' << r.position.y << ',' << r.size.x << ',' << r.size.y;
+        }
+        std::ostringstream hex;
+        hex << std::hex << std::hash<std::string>{}(oss.str());
+        return hex.str();
+    }
+}
+
+unsigned TextureAtlas::pageSizeFor(unsigned requested)
+{
+    return std::min(requested, sf::Texture::getMaximumSize());
+}
+
+TextureAtlas::Packed TextureAtlas::pack(const std::vector<Source> & sources, unsigned pageSize,
+                                        const std::string & cacheDir)
+{
+    Packed out;
+    const bool decodes = std::any_of(sources.begin(), sources.end(),
+                                     [](const Source & s) { return !s.pixels; });
+    const bool cached  = decodes && !cacheDir.empty();
+    const std::string signature = cached ? makeSignature(sources, pageSize) : "";
+    if (cached && loadCache(cacheDir, signature, out)) return out;
+
+    std::vector<Group> groups;
+    for (const auto & s : sources) {
+        Group g;
+        g.source = &s;
+        if (s.pixels) {
+            g.image = sf::Image(s.size, s.pixels);
+        } else if (!g.image.loadFromFile(s.path)) {
+            std::cerr << "[Assets] Atlas cannot read: " << s.name << " <- " << s.path << "\n";
+            continue;
+        }
+        const sf::IntRect whole{ {0, 0}, sf::Vector2i(g.image.getSize()) };
+        g.rects = s.rects.empty() ? std::vector<sf::IntRect>{ whole } : s.rects;
+        for (const auto & r : g.rects) g.area += static_cast<long long>(r.size.x) * r.size.y;
+        groups.push_back(std::move(g));
+    }
+    std::sort(groups.begin(), groups.end(),
+              [](const Group & a, const Group & b) { return a.area > b.area; });
+
+    const int size = static_cast<int>(pageSize);
+    std::vector<Skyline> skylines;
+
+    for (const auto & g : groups) {
+        std::vector<std::size_t> order(g.rects.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+                  [&](std::size_t a, std::size_t b) { return g.rects[a].size.y > g.rects[b].size.y; });
+
+        // try every page of matching filtering, then a fresh one
+        bool placed = false;
+        for (std::size_t p = 0; p <= skylines.size() && !placed; ++p) {
+            if (p < skylines.size() && out.smooth[p] != g.source->smooth) continue;
+
+            Skyline trial = p < skylines.size() ? skylines[p] : Skyline(size, size);
+            std::vector<sf::Vector2i> slots(g.rects.size());
+            bool ok = true;
+            for (std::size_t i : order) {
+                const auto & r = g.rects[i];
+                auto slot = trial.insert(r.size.x + 2 * BORDER, r.size.y + 2 * BORDER);
+                if (!slot) { ok = false; break; }
+                slots[i] = *slot + sf::Vector2i{BORDER, BORDER};
+            }
+            if (!ok) continue;
+
+            if (p == skylines.size()) {
+                skylines.push_back(trial);
+                out.images.emplace_back(sf::Vector2u(pageSize, pageSize), sf::Color::Transparent);
+                out.smooth.push_back(g.source->smooth);
+            } else {
+                skylines[p] = trial;
+            }
+
+            auto & entry = out.entries[g.source->name];
+            entry.page = p;
+            for (std::size_t i = 0; i < g.rects.size(); ++i) {
+                blit(out.images[p], g.image, g.rects[i], slots[i]);
+                entry.regions.push_back({ g.rects[i], { slots[i], g.rects[i].size } });
+            }
+            placed = true;
+        }
+
+        if (!placed)
+            std::cerr << "[Assets] Atlas: '" << g.source->name << "' does not fit a "
+                      << pageSize << "px page, left unpacked\n";
+    }
+
+    if (cached) saveCache(cacheDir, signature, out);
+    return out;
+}
+
+bool TextureAtlas::upload(Packed packed)
+{
+    clear();
+    m_pages.resize(packed.images.size());
+    for (std::size_t p = 0; p < packed.images.size(); ++p) {
+        if (!m_pages[p].loadFromImage(packed.images[p]))
+            std::cerr << "[Assets] Atlas page upload failed: " << p << "\n";
+        m_pages[p].setSmooth(packed.smooth[p]);
+    }
+    m_entries = std::move(packed.entries);
+    return !m_pages.empty();
+}
+
+bool TextureAtlas::build(const std::vector<Source> & sources, unsigned pageSize,
+                         const std::string & cacheDir)
+{
+    return upload(pack(sources, pageSizeFor(pageSize), cacheDir));
+}
+
+// Cache layout (text index next to one PNG per page):
+//   Signature <hash>
+//   Page   <index> <file> <smooth>
+//   Region <texture> <page> <srcX> <srcY> <w> <h> <x> <y>
+bool TextureAtlas::loadCache(const std::string & dir, const std::string & signature, Packed & out)
+{
+    std::ifstream fin(fs::path(dir) / "atlas.txt");
+    if (!fin) return false;
+
+    std::string line, kind;
+    if (!std::getline(fin, line)) return false;
+    std::istringstream head(line);
+    std::string cached;
+    head >> kind >> cached;
+    if (kind != "Signature" || cached != signature) return false;
+
+    Packed packed;
+    while (std::getline(fin, line)) {
+        std::istringstream iss(line);
+        iss >> kind;
+        if (kind == "Page") {
+            std::size_t index = 0; std::string file; bool smooth = true;
+            iss >> index >> file >> smooth;
+            if (index >= packed.images.size()) {
+                packed.images.resize(index + 1);
+                packed.smooth.resize(index + 1, true);
+            }
+            if (!packed.images[index].loadFromFile(fs::path(dir) / file)) return false;
+            packed.smooth[index] = smooth;
+        } else if (kind == "Region") {
+            std::string name; std::size_t page = 0;
+            int sx, sy, w, h, x, y;
+            iss >> name >> page >> sx >> sy >> w >> h >> x >> y;
+            auto & entry = packed.entries[name];
+            entry.page = page;
+            entry.regions.push_back({ { {sx, sy}, {w, h} }, { {x, y}, {w, h} } });
+        }
+    }
+    if (packed.images.empty()) return false;
+    out = std::move(packed);
+    return true;
+}
+
+void TextureAtlas::saveCache(const std::string & dir, const std::string & signature, const Packed & packed)
+{
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+
+    std::ofstream fout(fs::path(dir) / "atlas.txt");
+    if (!fout) {
+        std::cerr << "[Assets] Cannot write atlas cache: " << dir << "\n";
+        return;
+    }
+
+    fout << "Signature " << signature << "\n";
+    for (std::size_t p = 0; p < packed.images.size(); ++p) {
+        const std::string file = "atlas_" + std::to_string(p) + ".png";
+        if (!packed.images[p].saveToFile(fs::path(dir) / file))
+            std::cerr << "[Assets] Cannot write atlas page: " << file << "\n";
+        fout << "Page " << p << " " << file << " " << packed.smooth[p] << "\n";
+    }
+    for (const auto & [name, entry] : packed.entries)
+        for (const auto & r : entry.regions)
+            fout << "Region " << name << " " << entry.page << " "
+                 << r.source.position.x << " " << r.source.position.y << " "
+                 << r.source.size.x << " " << r.source.size.y << " "
+                 << r.rect.position.x << " " << r.rect.position.y << "\n";
+}
+
+void TextureAtlas::clear()
+{
+    m_pages.clear();
+    m_entries.clear();
+}
+
+bool TextureAtlas::contains(const std::string & texture) const
+{
+    return m_entries.count(texture) != 0;
+}
+
+std::optional<TextureAtlas::Mapping> TextureAtlas::map(const std::string & texture,
+                                                       const sf::IntRect & rect) const
+{
+    auto it = m_entries.find(texture);
+    if (it == m_entries.end()) return std::nullopt;
+
+    for (const auto & r : it->second.regions) {
+        const sf::Vector2i d = rect.position - r.source.position;
+        if (d.x < 0 || d.y < 0 ||
+            d.x + rect.size.x > r.source.size.x || d.y + rect.size.y > r.source.size.y) continue;
+        return Mapping{ &m_pages[it->second.page], { r.rect.position + d, rect.size } };
+    }
+    return std::nullopt;
+}
+
+std::size_t TextureAtlas::pageCount() const { return m_pages.size(); }
+const sf::Texture & TextureAtlas::page(std::size_t i) const { return m_pages.at(i); }
@@ -0,0 +1,160 @@
+#include "../include/TextureCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+TextureCache::Entry * TextureCache::entry(TextureId id)
+{
+    if (id.index >= m_entries.size() || !m_entries[id.index].texture) return nullptr;
+    return &m_entries[id.index];
+}
+
+void TextureCache::add(TextureId id, sf::Texture & texture, Source source, bool resident)
+{
+    if (id.index >= m_entries.size()) m_entries.resize(id.index + 1);
+
+    Entry & e = m_entries[id.index];
+    if (e.resident) m_stats.residentBytes -= e.bytes;
+    e.texture  = &texture;
+    e.source   = std::move(source);
+    e.bytes    = std::size_t(e.source.size.x) * e.source.size.y * 4;
+    e.resident = resident;
+    e.decoding = {};
+    if (resident)
+    {
+        m_stats.residentBytes += e.bytes;
+        m_stats.peakBytes = std::max(m_stats.peakBytes, m_stats.residentBytes);
+    }
+}
+
+void TextureCache::load(Entry & e)
+{
+    ++m_stats.misses;
+
+    // a prefetch still running is waited for rather than decoded twice
+    if (e.decoding.valid())
+    {
+        auto image = e.decoding.get();
+        upload(e, image ? &*image : nullptr);
+        return;
+    }
+    if (e.source.pixels)
+    {
+        upload(e, nullptr);
+        return;
+    }
+
+    sf::Image image;
+    if (!image.loadFromFile(e.source.path))
+        std::cerr << "[Assets] Failed texture reload: " << e.source.path << "\n";
+    upload(e, &image);
+}
+
+void TextureCache::upload(Entry & e, const sf::Image * image)
+{
+    // a failed load still counts as resident, so a missing file is not retried every frame
+    bool ok = false;
+    if (image && image->getSize().x > 0)
+    {
+        ok = e.texture->loadFromImage(*image);
+    }
+    else if (e.source.pixels && e.texture->resize(e.source.size))
+    {
+        e.texture->update(e.source.pixels);
+        ok = true;
+    }
+    if (!ok) *e.texture = sf::Texture{};
+    e.texture->setSmooth(e.source.smooth);
+
+    e.bytes    = std::size_t(e.texture->getSize().x) * e.texture->getSize().y * 4;
+    e.resident = true;
+    m_stats.residentBytes += e.bytes;
+    m_stats.peakBytes = std::max(m_stats.peakBytes, m_stats.residentBytes);
+}
+
+void TextureCache::evict(Entry & e)
+{
+    *e.texture = sf::Texture{};
+    e.resident = false;
+    m_stats.residentBytes -= e.bytes;
+    ++m_stats.evictions;
+}
+
+void TextureCache::prefetch(TextureId id)
+{
+    Entry * e = entry(id);
+    if (!e || e->resident || e->decoding.valid()) return;
+
+    // keep it from being evicted again before it is drawn
+    e->lastUsed = m_frame;
+    ++m_stats.prefetches;
+
+    // bundled pixels are already decoded; only files are worth a worker
+    if (e->source.pixels)
+    {
+        upload(*e, nullptr);
+        return;
+    }
+    if (!m_decoder) m_decoder = std::make_unique<ThreadPool>(1);
+    e->decoding = m_decoder->submit([path = e->source.path]() -> std::optional<sf::Image> {
+        sf::Image img;
+        if (!img.loadFromFile(path)) return std::nullopt;
+        return img;
+    });
+}
+
+void TextureCache::update()
+{
+    for (auto & e : m_entries)
+    {
+        if (!e.decoding.valid() || e.decoding.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            continue;
+        auto image = e.decoding.get();
+        if (!e.resident)
+        {
+            if (!image) std::cerr << "[Assets] Failed texture prefetch: " << e.source.path << "\n";
+            upload(e, image ? &*image : nullptr);
+        }
+    }
+
+    trim();
+    ++m_frame;
+}
+
+void TextureCache::trim()
+{
+    if (m_budget == 0 || m_stats.residentBytes <= m_budget) return;
+
+    // oldest first; anything the in-flight frames may still draw stays
+    std::vector<Entry *> candidates;
+    for (auto & e : m_entries)
+        if (e.texture && e.resident && e.lastUsed + IN_FLIGHT_FRAMES <= m_frame)
+            candidates.push_back(&e);
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Entry * a, const Entry * b) { return a->lastUsed < b->lastUsed; });
+
+    for (Entry * e : candidates)
+    {
+        if (m_stats.residentBytes <= m_budget) break;
+        evict(*e);
+    }
+}
+
+sf::Vector2u TextureCache::size(TextureId id) const
+{
+    return id.index < m_entries.size() ? m_entries[id.index].source.size : sf::Vector2u{};
+}
+
+bool TextureCache::resident(TextureId id) const
+{
+    return id.index < m_entries.size() && m_entries[id.index].resident;
+}
+
+void TextureCache::resetStats()
+{
+    const std::size_t bytes = m_stats.residentBytes;
+    m_stats = {};
+    m_stats.residentBytes = bytes;
+    m_stats.peakBytes     = bytes;
+}
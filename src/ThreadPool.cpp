@@ -0,0 +1,42 @@
+#include "../include/ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(std::size_t threads)
+{
+    if (threads == 0)
+    {
+        const std::size_t hw = std::thread::hardware_concurrency();
+        threads = std::max<std::size_t>(1, hw > 1 ? hw - 1 : 1);
+    }
+    m_workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+        m_workers.emplace_back(&ThreadPool::workerMain, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_tasks.clear();
+    }
+    m_wake.notify_all();
+    for (auto & w : m_workers) w.join();
+}
+
+void ThreadPool::workerMain()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || !m_tasks.empty(); });
+            if (m_stop) return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
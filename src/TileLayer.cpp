@@ -0,0 +1,178 @@
+#include "../include/TileLayer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    inline bool overlaps(const sf::FloatRect & a, const sf::FloatRect & b)
+    {
+        return a.position.x < b.position.x + b.size.x && b.position.x < a.position.x + a.size.x
+            && a.position.y < b.position.y + b.size.y && b.position.y < a.position.y + a.size.y;
+    }
+}
+
+TileLayer::TileLayer(const sf::Vector2f & cellSize, int chunkCells)
+: m_cellSize(cellSize)
+, m_chunkCells(chunkCells > 0 ? chunkCells : 32)
+{
+}
+
+std::uint64_t TileLayer::key(int cx, int cy)
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32)
+         |  static_cast<std::uint64_t>(static_cast<std::uint32_t>(cy));
+}
+
+sf::Vector2i TileLayer::chunkOf(const sf::Vector2f & p) const
+{
+    return { static_cast<int>(std::floor(p.x / (m_cellSize.x * m_chunkCells))),
+             static_cast<int>(std::floor(p.y / (m_cellSize.y * m_chunkCells))) };
+}
+
+bool TileLayer::canBake(const Entity & e, const AnimationClip & clip)
+{
+    return e.hasComponent<CAnimation>() && e.hasComponent<CTransform>() && !e.hasComponent<CShape>()
+        && clip.texture && clip.length <= 0.f;
+}
+
+void TileLayer::add(const std::shared_ptr<Entity> & e, const AnimationClip & clip)
+{
+    if (!canBake(*e, clip)) return;
+    remove(*e);
+
+    const auto & tf = e->getComponent<CTransform>();
+    const auto & ca = e->getComponent<CAnimation>();
+
+    Tile tile;
+    tile.entity  = e;
+    tile.texture   = clip.texture;
+    tile.textureId = clip.textureId;
+    RenderQueue::makeQuad(tile.quad, ca.rect(clip), clip.origin,
+                          sf::Vector2f{tf.pos.x, tf.pos.y},
+                          sf::Vector2f{tf.scale.x, tf.scale.y},
+                          tf.angle, sf::Color::White);
+
+    const sf::Vector2i c = chunkOf({tf.pos.x, tf.pos.y});
+    const std::uint64_t k = key(c.x, c.y);
+    auto & chunk = m_chunks[k];
+    chunk.tiles.push_back(std::move(tile));
+    chunk.dirty = true;
+    m_tileChunk[e->id()] = k;
+}
+
+void TileLayer::remove(const Entity & e)
+{
+    auto it = m_tileChunk.find(e.id());
+    if (it == m_tileChunk.end()) return;
+
+    auto & chunk = m_chunks[it->second];
+    auto pos = std::find_if(chunk.tiles.begin(), chunk.tiles.end(),
+                            [&](const Tile & t) { return t.entity->id() == e.id(); });
+    if (pos != chunk.tiles.end())
+    {
+        *pos = std::move(chunk.tiles.back());
+        chunk.tiles.pop_back();
+        chunk.dirty = true;
+    }
+    m_tileChunk.erase(it);
+}
+
+void TileLayer::clear()
+{
+    m_chunks.clear();
+    m_tileChunk.clear();
+}
+
+void TileLayer::bake(Chunk & chunk)
+{
+    std::vector<std::shared_ptr<StaticMesh>> meshes;
+    chunk.textures.clear();
+
+    bool first = true;
+    for (const auto & t : chunk.tiles)
+    {
+        auto it = std::find_if(meshes.begin(), meshes.end(),
+                               [&](const auto & m) { return m->texture == t.texture; });
+        if (it == meshes.end())
+        {
+            auto mesh = std::make_shared<StaticMesh>();
+            mesh->id      = StaticMesh::nextId();
+            mesh->texture = t.texture;
+            meshes.push_back(std::move(mesh));
+            it = meshes.end() - 1;
+            if (t.textureId) chunk.textures.push_back(t.textureId);
+        }
+        (*it)->vertices.insert((*it)->vertices.end(), t.quad, t.quad + 6);
+
+        for (const auto & v : t.quad)
+        {
+            if (first) { chunk.bounds = { v.position, {0.f, 0.f} }; first = false; }
+            const float x0 = std::min(chunk.bounds.position.x, v.position.x);
+            const float y0 = std::min(chunk.bounds.position.y, v.position.y);
+            const float x1 = std::max(chunk.bounds.position.x + chunk.bounds.size.x, v.position.x);
+            const float y1 = std::max(chunk.bounds.position.y + chunk.bounds.size.y, v.position.y);
+            chunk.bounds = { {x0, y0}, {x1 - x0, y1 - y0} };
+        }
+    }
+
+    // frames already recorded keep the old meshes alive until they are drawn
+    chunk.meshes.assign(meshes.begin(), meshes.end());
+    chunk.dirty = false;
+    ++m_rebakes;
+}
+
+void TileLayer::draw(RenderQueue & queue, RenderLayer layer, const sf::FloatRect & area)
+{
+    // tiles may overhang their chunk slightly, so look one chunk further out
+    const sf::Vector2i c0 = chunkOf(area.position) - sf::Vector2i{1, 1};
+    const sf::Vector2i c1 = chunkOf(area.position + area.size) + sf::Vector2i{1, 1};
+    m_texturesDrawn.clear();
+
+    for (int cy = c0.y; cy <= c1.y; ++cy)
+    {
+        for (int cx = c0.x; cx <= c1.x; ++cx)
+        {
+            auto it = m_chunks.find(key(cx, cy));
+            if (it == m_chunks.end()) continue;
+
+            auto & chunk = it->second;
+            if (chunk.dirty) bake(chunk);
+            if (chunk.tiles.empty() || !overlaps(chunk.bounds, area)) continue;
+
+            for (const auto & mesh : chunk.meshes) queue.draw(layer, 0.f, mesh);
+            m_texturesDrawn.insert(m_texturesDrawn.end(), chunk.textures.begin(), chunk.textures.end());
+            ++m_chunksDrawn;
+        }
+    }
+}
+
+void TileLayer::query(const sf::FloatRect & area, EntityVec & out) const
+{
+    const sf::Vector2i c0 = chunkOf(area.position) - sf::Vector2i{1, 1};
+    const sf::Vector2i c1 = chunkOf(area.position + area.size) + sf::Vector2i{1, 1};
+
+    for (int cy = c0.y; cy <= c1.y; ++cy)
+    {
+        for (int cx = c0.x; cx <= c1.x; ++cx)
+        {
+            auto it = m_chunks.find(key(cx, cy));
+            if (it == m_chunks.end()) continue;
+
+            for (const auto & t : it->second.tiles)
+            {
+                if (!t.entity->isActive()) continue;
+                const auto & p = t.entity->getComponent<CTransform>().pos;
+                if (p.x >= area.position.x && p.x <= area.position.x + area.size.x &&
+                    p.y >= area.position.y && p.y <= area.position.y + area.size.y)
+                    out.push_back(t.entity);
+            }
+        }
+    }
+}
+
+std::size_t TileLayer::tileCount()   const { return m_tileChunk.size(); }
+std::size_t TileLayer::chunkCount()  const { return m_chunks.size(); }
+std::size_t TileLayer::chunksDrawn() const { return m_chunksDrawn; }
+
+const std::vector<TextureId> & TileLayer::texturesDrawn() const { return m_texturesDrawn; }
+std::size_t TileLayer::rebakes()     const { return m_rebakes; }
+void        TileLayer::resetStats()        { m_chunksDrawn = 0; m_rebakes = 0; }
@@ -0,0 +1,311 @@
+#include "../include/WorldStreamer.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+namespace {
+    constexpr char          MAGIC[8] = { 'S', 'F', 'C', 'H', 'U', 'N', 'K', 0 };
+    constexpr std::uint32_t VERSION  = 1;
+
+    struct FileHeader
+    {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t nameBytes;
+        std::uint32_t nameCount;
+        std::uint32_t recordCount;
+    };
+
+    static_assert(std::is_trivially_copyable_v<WorldStreamer::Record>);
+
+    WorldStreamer::ChunkData readChunk(const std::string & path)
+    {
+        WorldStreamer::ChunkData data;
+        std::ifstream in(path, std::ios::binary);
+        FileHeader h{};
+        if (!in || !in.read(reinterpret_cast<char *>(&h), sizeof(h))
+            || std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.version != VERSION)
+        {
+            if (in.is_open()) std::cerr << "[World] Bad chunk file " << path << "\n";
+            return data;
+        }
+
+        std::string names(h.nameBytes, '\0');
+        data.records.resize(h.recordCount);
+        if (!in.read(names.data(), static_cast<std::streamsize>(names.size()))
+            || !in.read(reinterpret_cast<char *>(data.records.data()),
+                        static_cast<std::streamsize>(data.records.size() * sizeof(WorldStreamer::Record))))
+        {
+            std::cerr << "[World] Truncated chunk file " << path << "\n";
+            return {};
+        }
+        for (std::size_t at = 0; at < names.size();)
+        {
+            const std::size_t end = names.find('\0', at);
+            if (end == std::string::npos) break;
+            data.names.emplace_back(names, at, end - at);
+            at = end + 1;
+        }
+
+        // records are trusted by the scene, so drop any that point past the names
+        if (data.names.size() != h.nameCount) return {};
+        std::erase_if(data.records, [&](const WorldStreamer::Record & r) {
+            return r.tag >= data.names.size() || r.anim >= data.names.size();
+        });
+        return data;
+    }
+
+    void writeChunk(const std::string & path, const WorldStreamer::ChunkData & data)
+    {
+        std::string names;
+        for (const auto & n : data.names) { names += n; names += '\0'; }
+
+        FileHeader h{};
+        std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.version     = VERSION;
+        h.nameBytes   = static_cast<std::uint32_t>(names.size());
+        h.nameCount   = static_cast<std::uint32_t>(data.names.size());
+        h.recordCount = static_cast<std::uint32_t>(data.records.size());
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        out.write(names.data(), static_cast<std::streamsize>(names.size()));
+        out.write(reinterpret_cast<const char *>(data.records.data()),
+                  static_cast<std::streamsize>(data.records.size() * sizeof(WorldStreamer::Record)));
+        if (!out) std::cerr << "[World] Cannot write chunk file " << path << "\n";
+    }
+
+    bool overlaps(const sf::FloatRect & a, const sf::FloatRect & b)
+    {
+        return a.position.x < b.position.x + b.size.x && b.position.x < a.position.x + a.size.x
+            && a.position.y < b.position.y + b.size.y && b.position.y < a.position.y + a.size.y;
+    }
+
+    sf::FloatRect grow(const sf::FloatRect & r, float by)
+    {
+        return { r.position - sf::Vector2f{by, by}, r.size + sf::Vector2f{2.f * by, 2.f * by} };
+    }
+}
+
+std::uint32_t WorldStreamer::ChunkData::name(const std::string & s)
+{
+    // a handful of names per chunk, so a scan beats a map
+    for (std::size_t i = 0; i < names.size(); ++i)
+        if (names[i] == s) return static_cast<std::uint32_t>(i);
+    names.push_back(s);
+    return static_cast<std::uint32_t>(names.size() - 1);
+}
+
+WorldStreamer::~WorldStreamer()
+{
+    end();
+}
+
+void WorldStreamer::begin(const std::string & dir, float chunkSize,
+                          const std::string & base, const std::string & source, ThreadPool * io)
+{
+    end();
+    m_dir       = dir;
+    m_base      = base;
+    m_chunkSize = chunkSize;
+    m_stats     = {};
+
+    // only this session's changes live here; the level itself stays in the base
+    std::error_code ec;
+    std::filesystem::remove_all(m_dir, ec);
+    std::filesystem::create_directories(m_dir, ec);
+    if (ec) std::cerr << "[World] Cannot create " << m_dir << ": " << ec.message() << "\n";
+
+    const auto size = std::filesystem::file_size(source, ec);
+    const auto time = ec ? 0 : std::filesystem::last_write_time(source, ec).time_since_epoch().count();
+    m_stamp = std::to_string(VERSION) + " " + std::to_string(size) + " " + std::to_string(time)
+            + " " + std::to_string(chunkSize);
+
+    std::string stamp;
+    std::ifstream in(m_base + "/stamp");
+    m_hasBase = !ec && in && std::getline(in, stamp) && stamp == m_stamp;
+    if (m_hasBase)
+    {
+        for (const auto & entry : std::filesystem::directory_iterator(m_base, ec))
+        {
+            if (entry.path().extension() != ".chunk") continue;
+            int cx = 0, cy = 0;
+            if (std::sscanf(entry.path().stem().string().c_str(), "%d_%d", &cx, &cy) == 2)
+                m_stored.insert(keyOf((cx + 0.5f) * m_chunkSize, (cy + 0.5f) * m_chunkSize));
+        }
+    }
+
+    // one thread keeps each chunk's reads and writes in submission order
+    if (!io) m_ownIo = std::make_unique<ThreadPool>(1);
+    m_io = io ? io : m_ownIo.get();
+}
+
+void WorldStreamer::end()
+{
+    if (!m_io) return;
+    for (auto & [key, c] : m_chunks)
+        if (c.load.valid()) c.load.wait();
+    for (auto & w : m_writes) w.wait();
+    m_writes.clear();
+    m_chunks.clear();
+    m_stored.clear();
+    m_written.clear();
+    m_ownIo.reset();
+    m_io = nullptr;
+}
+
+std::string WorldStreamer::file(const std::string & dir, Key key) const
+{
+    const auto cx = static_cast<std::int32_t>(key >> 32);
+    const auto cy = static_cast<std::int32_t>(key & 0xffffffffu);
+    return dir + "/" + std::to_string(cx) + "_" + std::to_string(cy) + ".chunk";
+}
+
+std::string WorldStreamer::readPath(Key key) const
+{
+    return file(m_written.count(key) ? m_dir : m_base, key);
+}
+
+WorldStreamer::Key WorldStreamer::keyOf(float x, float y) const
+{
+    const auto cx = static_cast<std::int32_t>(std::floor(x / m_chunkSize));
+    const auto cy = static_cast<std::int32_t>(std::floor(y / m_chunkSize));
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32) | static_cast<std::uint32_t>(cy);
+}
+
+sf::FloatRect WorldStreamer::bounds(Key key) const
+{
+    const auto cx = static_cast<std::int32_t>(key >> 32);
+    const auto cy = static_cast<std::int32_t>(key & 0xffffffffu);
+    return { {cx * m_chunkSize, cy * m_chunkSize}, {m_chunkSize, m_chunkSize} };
+}
+
+void WorldStreamer::writeBase(const std::unordered_map<Key, ChunkData> & chunks)
+{
+    std::error_code ec;
+    std::filesystem::remove_all(m_base, ec);
+    std::filesystem::create_directories(m_base, ec);
+    if (ec)
+    {
+        std::cerr << "[World] Cannot create " << m_base << ": " << ec.message() << "\n";
+        return;
+    }
+
+    for (const auto & [key, data] : chunks)
+    {
+        writeChunk(file(m_base, key), data);
+        m_stored.insert(key);
+    }
+    std::ofstream(m_base + "/stamp") << m_stamp << "\n";
+    m_hasBase = true;
+}
+
+void WorldStreamer::submitWrite(Key key, ChunkData data, bool append)
+{
+    // an append merges into whichever copy is current; the result always lands in the session's directory
+    const std::string from = readPath(key);
+    m_stored.insert(key);
+    m_written.insert(key);
+    m_writes.push_back(m_io->submit([from, path = file(m_dir, key), data = std::move(data), append]() {
+        if (!append) { writeChunk(path, data); return; }
+
+        // re-map the newcomers' names onto the chunk's own table
+        ChunkData merged = readChunk(from);
+        for (Record r : data.records)
+        {
+            r.tag  = merged.name(data.names[r.tag]);
+            r.anim = merged.name(data.names[r.anim]);
+            merged.records.push_back(r);
+        }
+        writeChunk(path, merged);
+    }));
+}
+
+std::vector<WorldStreamer::Key> WorldStreamer::update(const sf::FloatRect & view)
+{
+    std::erase_if(m_writes, [](const std::future<void> & w) {
+        return w.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+
+    // load one chunk ahead of the view, unload two behind; the gap keeps a
+    // chunk on the boundary from streaming in and out every frame
+    const sf::FloatRect load = grow(view, m_chunkSize);
+    const sf::FloatRect keep = grow(view, 2.f * m_chunkSize);
+
+    const auto cell = [&](float v) { return static_cast<int>(std::floor(v / m_chunkSize)); };
+    for (int cy = cell(load.position.y); cy <= cell(load.position.y + load.size.y); ++cy)
+    {
+        for (int cx = cell(load.position.x); cx <= cell(load.position.x + load.size.x); ++cx)
+        {
+            const Key key = keyOf((cx + 0.5f) * m_chunkSize, (cy + 0.5f) * m_chunkSize);
+            auto [it, added] = m_chunks.try_emplace(key);
+            if (!added) continue;
+
+            // chunks that were never stored are empty and resident right away
+            if (m_stored.count(key))
+            {
+                it->second.state = State::Loading;
+                it->second.load  = m_io->submit([path = readPath(key)] { return readChunk(path); });
+            }
+        }
+    }
+
+    std::vector<Key> far;
+    m_stats.resident = m_stats.loading = 0;
+    for (const auto & [key, c] : m_chunks)
+    {
+        if (c.state == State::Loading) { ++m_stats.loading; continue; }
+        ++m_stats.resident;
+        if (!overlaps(bounds(key), keep)) far.push_back(key);
+    }
+    return far;
+}
+
+std::vector<std::pair<WorldStreamer::Key, WorldStreamer::ChunkData>> WorldStreamer::takeLoaded()
+{
+    std::vector<std::pair<Key, ChunkData>> done;
+    for (auto & [key, c] : m_chunks)
+    {
+        if (c.state != State::Loading
+            || c.load.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            continue;
+        c.state = State::Resident;
+        done.emplace_back(key, c.load.get());
+        ++m_stats.loads;
+    }
+    return done;
+}
+
+void WorldStreamer::waitLoads()
+{
+    for (auto & [key, c] : m_chunks)
+        if (c.state == State::Loading) c.load.wait();
+}
+
+bool WorldStreamer::resident(Key key) const
+{
+    auto it = m_chunks.find(key);
+    return it != m_chunks.end() && it->second.state == State::Resident;
+}
+
+void WorldStreamer::store(Key key, ChunkData data)
+{
+    m_chunks.erase(key);
+    ++m_stats.unloads;
+    if (data.records.empty() && !m_stored.count(key)) return;
+    submitWrite(key, std::move(data), false);
+}
+
+bool WorldStreamer::migrate(Key key, ChunkData data)
+{
+    if (!m_io || m_chunks.count(key)) return false;
+    submitWrite(key, std::move(data), true);
+    ++m_stats.migrations;
+    return true;
+}
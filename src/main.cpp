@@ -1,9 +1,71 @@
 #include "../include/GameEngine.h"
+#include "../include/RoomServer.h"
+#include "../include/Scene_Menu.h"
+#include "../include/Scene_Play.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// usage: game [config] [--headless] [--level file] [--frames n] [--record file | --replay file]
+//        game [config] --server rooms --level file [--lanes n] [--frames n]
+//   --level  starts straight into a level instead of the menu
+//   --frames simulates n frames as fast as possible (no drawing or pacing) and exits
+//   --server hosts that many headless rooms of the level, ticked at 60Hz; --frames
+//            stops after n ticks and prints the server stats
+namespace {
+    int runServer(const std::string& assetsPath, int argc, char** argv)
+    {
+        RoomServerConfig config;
+        std::size_t rooms = 0, ticks = 0;
+        std::string level;
+        for (int i = 1; i + 1 < argc; ++i) {
+            if (std::strcmp(argv[i], "--server") == 0) rooms = std::strtoull(argv[++i], nullptr, 10);
+            else if (std::strcmp(argv[i], "--lanes") == 0) config.lanes = std::strtoull(argv[++i], nullptr, 10);
+            else if (std::strcmp(argv[i], "--frames") == 0) ticks = std::strtoull(argv[++i], nullptr, 10);
+            else if (std::strcmp(argv[i], "--level") == 0) level = argv[++i];
+        }
+        if (level.empty()) {
+            std::cerr << "[Server] --server needs --level\n";
+            return 1;
+        }
+
+        RoomServer server(assetsPath, config);
+        for (std::size_t i = 0; i < rooms; ++i) server.addRoom(level);
+        server.run(ticks);
+        server.printStats();
+        return 0;
+    }
+}
 
 int main(int argc, char** argv)
 {
-    const std::string assetsPath = (argc > 1) ? argv[1] : "config.txt"; // or "assets.txt" if that's your file
-    GameEngine game(assetsPath);
-    game.run();
+    const std::string assetsPath = (argc > 1 && argv[1][0] != '-') ? argv[1] : "config.txt"; // or "assets.txt" if that's your file
+
+    for (int i = 1; i < argc; ++i)
+        if (std::strcmp(argv[i], "--server") == 0) return runServer(assetsPath, argc, argv);
+
+    bool headless = false;
+    for (int i = 1; i < argc; ++i) headless = headless || std::strcmp(argv[i], "--headless") == 0;
+    GameEngine game(assetsPath, headless);
+
+    std::size_t frames = 0;
+    bool level = false;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--record") == 0) game.recordInput(argv[++i]);
+        else if (std::strcmp(argv[i], "--replay") == 0 && !game.replayInput(argv[++i])) return 1;
+        else if (std::strcmp(argv[i], "--frames") == 0) frames = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--level") == 0) {
+            game.assets().finishLoad();
+            game.changeScene("PLAY", std::make_shared<Scene_Play>(&game, argv[++i]), true);
+            level = true;
+        }
+    }
+
+    // a headless engine starts without the menu; replays of menu sessions still need it
+    if (headless && !level) game.changeScene("Menu", std::make_shared<Scene_Menu>(&game));
+
+    if (frames) game.simulate(frames);
+    else        game.run();
     return 0;
 }
@@ -0,0 +1,121 @@
+// Packs the assets listed in a config file into one pre-decoded bundle that
+// Assets::loadBundle maps at startup (see AssetBundle.h).
+//
+//   bundle_builder config.txt assets.bundle
+//
+// Texture, Font and Sound lines become decoded entries; every other line is
+// kept, in order, as config text applied after the assets are loaded.
+// Paths are resolved like the game does, relative to the working directory.
+
+#include "../include/AssetBundle.h"
+
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+namespace {
+    bool readFile(const std::string & path, std::vector<std::uint8_t> & out)
+    {
+        std::ifstream fin(path, std::ios::binary);
+        if (!fin) return false;
+        out.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+        return true;
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: " << argv[0] << " <config.txt> <out.bundle>\n";
+        return 2;
+    }
+
+    std::ifstream fin(argv[1]);
+    if (!fin)
+    {
+        std::cerr << "[Bundle] Cannot open config: " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::vector<AssetBundle::Item> items;
+    std::string config;
+    std::string line;
+    std::size_t ln = 0;
+    int failures = 0;
+
+    while (std::getline(fin, line))
+    {
+        ++ln;
+        std::istringstream iss(line);
+        std::string kind, name, path;
+        iss >> kind >> name >> path;
+
+        if (kind != "Texture" && kind != "Font" && kind != "Sound")
+        {
+            config += line;
+            config += '\n';
+            continue;
+        }
+        if (name.empty() || path.empty())
+        {
+            std::cerr << "[Bundle] Bad " << kind << " line " << ln << "\n";
+            ++failures;
+            continue;
+        }
+
+        AssetBundle::Item item;
+        item.name = name;
+        item.path = path;
+
+        if (kind == "Texture")
+        {
+            sf::Image image;
+            if (!image.loadFromFile(path)) { std::cerr << "[Bundle] Cannot decode " << path << "\n"; ++failures; continue; }
+            item.kind = AssetBundle::Kind::Texture;
+            item.a    = image.getSize().x;
+            item.b    = image.getSize().y;
+            item.c    = 1;    // the config loader always makes textures smooth
+            const std::uint8_t * px = image.getPixelsPtr();
+            item.data.assign(px, px + std::size_t(item.a) * item.b * 4);
+        }
+        else if (kind == "Font")
+        {
+            item.kind = AssetBundle::Kind::Font;
+            if (!readFile(path, item.data)) { std::cerr << "[Bundle] Cannot read " << path << "\n"; ++failures; continue; }
+        }
+        else
+        {
+            sf::SoundBuffer sound;
+            if (!sound.loadFromFile(path)) { std::cerr << "[Bundle] Cannot decode " << path << "\n"; ++failures; continue; }
+            item.kind = AssetBundle::Kind::Sound;
+            item.a    = sound.getChannelCount();
+            item.b    = sound.getSampleRate();
+
+            // channel map first, then the samples on an 8-byte boundary
+            for (const auto c : sound.getChannelMap()) item.data.push_back(static_cast<std::uint8_t>(c));
+            item.c = static_cast<std::uint32_t>((item.data.size() + 7) & ~std::size_t(7));
+            item.data.resize(item.c);
+            const auto bytes = static_cast<std::size_t>(sound.getSampleCount()) * sizeof(std::int16_t);
+            item.data.resize(item.c + bytes);
+            if (bytes) std::memcpy(item.data.data() + item.c, sound.getSamples(), bytes);
+        }
+
+        std::cout << kind << ' ' << name << ": " << item.data.size() << " bytes\n";
+        items.push_back(std::move(item));
+    }
+
+    AssetBundle::Item cfg;
+    cfg.kind = AssetBundle::Kind::Config;
+    cfg.name = "config";
+    cfg.data.assign(config.begin(), config.end());
+    items.push_back(std::move(cfg));
+
+    if (!AssetBundle::write(argv[2], items)) return 1;
+    std::cout << "wrote " << items.size() << " entries to " << argv[2] << "\n";
+    return failures ? 1 : 0;
+}